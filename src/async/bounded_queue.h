@@ -0,0 +1,272 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * What a BoundedQueue does with an item pushed while it is full.
+ *
+ * BLOCK:       The pushing thread waits until there is room.
+ * DROP_NEWEST: The pushed item is discarded.
+ * DROP_OLDEST: The oldest queued item is discarded to make room.
+ * CONFLATE:    The pushed item replaces the newest queued item, so the queue always ends
+ *              with the latest value. Suits state updates where only the latest matters.
+ */
+enum class OverflowPolicy {
+    BLOCK,
+    DROP_NEWEST,
+    DROP_OLDEST,
+    CONFLATE,
+};
+
+/**
+ * A snapshot of a BoundedQueue's counters.
+ *
+ * `high_water_mark` is the greatest depth the queue has reached. `dropped_count` counts
+ * items discarded by DROP_NEWEST and DROP_OLDEST, and `conflated_count` counts items
+ * replaced by CONFLATE.
+ */
+struct QueueMetrics {
+    std::size_t depth;
+    std::size_t capacity;
+    std::size_t high_water_mark;
+    std::uint64_t pushed_count;
+    std::uint64_t dropped_count;
+    std::uint64_t conflated_count;
+};
+
+/**
+ * A thread safe FIFO queue of at most `capacity` items, all allocated up front so its
+ * memory use never grows. `overflow_policy` decides what happens when pushing to a full
+ * queue.
+ *
+ * Used for the mailboxes of Strands, the LatencyWatchdog's demoted event queue and
+ * EventQueues.
+ */
+template<class ITEM_TYPE>
+class BoundedQueue {
+
+public:
+
+    BoundedQueue(std::size_t capacity, OverflowPolicy overflow_policy);
+
+    /**
+     * Returns false only if `item` was discarded, which only happens under DROP_NEWEST.
+     */
+    bool push(ITEM_TYPE item);
+
+    std::optional<ITEM_TYPE> try_pop();
+
+    /**
+     * Removes every queued item for which `predicate` returns true, returning how many were
+     * removed. Removed items are not counted as dropped.
+     */
+    template<class PREDICATE_TYPE>
+    std::size_t erase_if(PREDICATE_TYPE predicate);
+
+    std::size_t get_depth() const;
+    std::size_t get_capacity() const;
+    OverflowPolicy get_overflow_policy() const;
+    QueueMetrics get_metrics() const;
+
+private:
+
+    ITEM_TYPE _pop_front();
+    void _push_back(ITEM_TYPE item);
+
+    const OverflowPolicy _overflow_policy;
+
+    mutable std::mutex _queue_mutex {};
+    std::condition_variable _not_full_condition {};
+
+    std::vector<std::optional<ITEM_TYPE>> _slot_list;
+    std::size_t _front_index = 0;
+    std::size_t _depth = 0;
+
+    std::size_t _high_water_mark = 0;
+    std::uint64_t _pushed_count = 0;
+    std::uint64_t _dropped_count = 0;
+    std::uint64_t _conflated_count = 0;
+};
+
+
+template<class ITEM_TYPE>
+inline BoundedQueue<ITEM_TYPE>::BoundedQueue(std::size_t capacity, OverflowPolicy overflow_policy)
+    : _overflow_policy(overflow_policy)
+    , _slot_list(std::max<std::size_t>(capacity, 1))
+{
+}
+
+template<class ITEM_TYPE>
+inline bool BoundedQueue<ITEM_TYPE>::push(ITEM_TYPE item)
+{
+    std::unique_lock lock { _queue_mutex };
+
+    ++_pushed_count;
+
+    if (_depth == _slot_list.size()) {
+        switch (_overflow_policy) {
+            case OverflowPolicy::BLOCK:
+                _not_full_condition.wait(lock, [this] { return _depth < _slot_list.size(); });
+                break;
+
+            case OverflowPolicy::DROP_NEWEST:
+                ++_dropped_count;
+                return false;
+
+            case OverflowPolicy::DROP_OLDEST:
+                ++_dropped_count;
+                _pop_front();
+                break;
+
+            case OverflowPolicy::CONFLATE:
+                ++_conflated_count;
+                _slot_list[(_front_index + _depth - 1) % _slot_list.size()] = std::move(item);
+                return true;
+        }
+    }
+
+    _push_back(std::move(item));
+
+    return true;
+}
+
+template<class ITEM_TYPE>
+inline std::optional<ITEM_TYPE> BoundedQueue<ITEM_TYPE>::try_pop()
+{
+    std::optional<ITEM_TYPE> item;
+
+    {
+        std::lock_guard lock { _queue_mutex };
+
+        if (_depth == 0) {
+            return std::nullopt;
+        }
+
+        item = _pop_front();
+    }
+
+    _not_full_condition.notify_one();
+
+    return item;
+}
+
+template<class ITEM_TYPE>
+template<class PREDICATE_TYPE>
+inline std::size_t BoundedQueue<ITEM_TYPE>::erase_if(PREDICATE_TYPE predicate)
+{
+    std::size_t erased_count = 0;
+
+    {
+        std::lock_guard lock { _queue_mutex };
+
+        const auto depth = _depth;
+
+        for (std::size_t item_index = 0; item_index < depth; ++item_index) {
+            auto item = _pop_front();
+
+            if (predicate(std::as_const(item))) {
+                ++erased_count;
+            }
+
+            else {
+                _push_back(std::move(item));
+            }
+        }
+    }
+
+    if (erased_count != 0) {
+        _not_full_condition.notify_all();
+    }
+
+    return erased_count;
+}
+
+template<class ITEM_TYPE>
+inline std::size_t BoundedQueue<ITEM_TYPE>::get_depth() const
+{
+    std::lock_guard lock { _queue_mutex };
+    return _depth;
+}
+
+template<class ITEM_TYPE>
+inline std::size_t BoundedQueue<ITEM_TYPE>::get_capacity() const
+{
+    return _slot_list.size();
+}
+
+template<class ITEM_TYPE>
+inline OverflowPolicy BoundedQueue<ITEM_TYPE>::get_overflow_policy() const
+{
+    return _overflow_policy;
+}
+
+template<class ITEM_TYPE>
+inline QueueMetrics BoundedQueue<ITEM_TYPE>::get_metrics() const
+{
+    std::lock_guard lock { _queue_mutex };
+
+    return {
+        .depth = _depth,
+        .capacity = _slot_list.size(),
+        .high_water_mark = _high_water_mark,
+        .pushed_count = _pushed_count,
+        .dropped_count = _dropped_count,
+        .conflated_count = _conflated_count,
+    };
+}
+
+template<class ITEM_TYPE>
+inline ITEM_TYPE BoundedQueue<ITEM_TYPE>::_pop_front()
+{
+    auto& slot = _slot_list[_front_index];
+    auto item = std::move(*slot);
+    slot.reset();
+
+    _front_index = (_front_index + 1) % _slot_list.size();
+    --_depth;
+
+    return item;
+}
+
+template<class ITEM_TYPE>
+inline void BoundedQueue<ITEM_TYPE>::_push_back(ITEM_TYPE item)
+{
+    _slot_list[(_front_index + _depth) % _slot_list.size()].emplace(std::move(item));
+    ++_depth;
+    _high_water_mark = std::max(_high_water_mark, _depth);
+}
+
+
+} // namespace dispatch
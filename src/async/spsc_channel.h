@@ -0,0 +1,308 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+
+namespace dispatch {
+
+
+/**
+ * A lock free, bounded ring of events of one type, from exactly one producer thread to
+ * exactly one consumer thread, for connecting dispatchers running on different threads.
+ *
+ * The producer's and consumer's indices live on separate cache lines, and each side keeps a
+ * cached copy of the other's index, so the two threads only touch each other's cache line
+ * when the channel looks full or empty. Writes can be batched: `try_write` stores an event
+ * without making it visible, and `publish` makes every written event visible with a single
+ * store. Likewise, `dispatch_available` frees all the slots it dispatched with a single store,
+including when a handler throws, after which the event that threw is not dispatched again.
+ *
+ * `capacity` is rounded up to a power of two.
+ *
+ * Refer to the "SPSC Channel" section of `README.md` for example usage.
+ */
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+class SpscChannel {
+
+public:
+
+    explicit SpscChannel(std::size_t capacity);
+    ~SpscChannel();
+
+    SpscChannel(const SpscChannel&) = delete;
+    SpscChannel& operator=(const SpscChannel&) = delete;
+
+    /**
+     * Producer only. Stores `event` without making it visible to the consumer, returning
+     * false if the channel is full.
+     */
+    template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+    bool try_write(ARGUMENT_TYPE_LIST&& ... argument_list);
+
+    /**
+     * Producer only. Makes every event written so far visible to the consumer.
+     */
+    void publish();
+
+    /**
+     * Producer only. Writes and publishes `event`, returning false if the channel is full.
+     */
+    bool try_push(EVENT_TYPE event);
+
+    /**
+     * Consumer only. Dispatches up to `max_event_count` published events with
+     * `event_dispatcher`, a BasicEventDispatcher of any configuration, oldest first,
+     * returning how many were dispatched.
+     */
+    template<class EVENT_DISPATCHER_TYPE>
+    std::size_t dispatch_available(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * Consumer only.
+     */
+    std::optional<EVENT_TYPE> try_pop();
+
+    std::size_t get_capacity() const;
+
+private:
+
+    static constexpr std::size_t _CACHE_LINE_SIZE_ = 64;
+
+    EVENT_TYPE* _get_slot(std::size_t index) const;
+
+    const std::size_t _index_mask;
+    std::allocator<EVENT_TYPE> _allocator {};
+    EVENT_TYPE* const _slot_list;
+
+    // Written by the producer only
+    alignas(_CACHE_LINE_SIZE_) std::atomic<std::size_t> _published_index = 0;
+    std::size_t _write_index = 0;
+    std::size_t _cached_read_index = 0;
+
+    // Written by the consumer only
+    alignas(_CACHE_LINE_SIZE_) std::atomic<std::size_t> _read_index = 0;
+    std::size_t _cached_published_index = 0;
+};
+
+/**
+ * Subscribes to EVENT_TYPE on one dispatcher, and writes each event it handles to an
+ * SpscChannel, for another thread to dispatch with `SpscChannel::dispatch_available`.
+ *
+ * Events are published to the consumer in batches of `batch_size`. Call `flush` to publish
+ * a partial batch, e.g. at the end of each iteration of the producing thread's loop. While
+ * the channel is full, handling an event waits for the consumer to make room.
+ */
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+class SpscChannelForwarder : public EventSubscriber<EVENT_TYPE> {
+
+public:
+
+    explicit SpscChannelForwarder(SpscChannel<EVENT_TYPE>& channel, std::size_t batch_size = 1);
+
+    void handle_event(const EVENT_TYPE& event) override;
+
+    void flush();
+
+private:
+
+    SpscChannel<EVENT_TYPE>& _channel;
+    const std::size_t _batch_size;
+    std::size_t _unpublished_count = 0;
+};
+
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline SpscChannel<EVENT_TYPE>::SpscChannel(std::size_t capacity)
+    : _index_mask(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1)
+    , _slot_list(_allocator.allocate(_index_mask + 1))
+{
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline SpscChannel<EVENT_TYPE>::~SpscChannel()
+{
+    for (auto index = _read_index.load(std::memory_order_relaxed); index != _write_index; ++index) {
+        std::destroy_at(_get_slot(index));
+    }
+
+    _allocator.deallocate(_slot_list, _index_mask + 1);
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+inline bool SpscChannel<EVENT_TYPE>::try_write(ARGUMENT_TYPE_LIST&& ... argument_list)
+{
+    if (_write_index - _cached_read_index > _index_mask) {
+        _cached_read_index = _read_index.load(std::memory_order_acquire);
+
+        if (_write_index - _cached_read_index > _index_mask) {
+            return false;
+        }
+    }
+
+    std::construct_at(_get_slot(_write_index), std::forward<ARGUMENT_TYPE_LIST>(argument_list)...);
+    ++_write_index;
+
+    return true;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline void SpscChannel<EVENT_TYPE>::publish()
+{
+    _published_index.store(_write_index, std::memory_order_release);
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline bool SpscChannel<EVENT_TYPE>::try_push(EVENT_TYPE event)
+{
+    if (!try_write(std::move(event))) {
+        return false;
+    }
+
+    publish();
+
+    return true;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t SpscChannel<EVENT_TYPE>::dispatch_available(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count)
+{
+    auto read_index = _read_index.load(std::memory_order_relaxed);
+
+    if (read_index == _cached_published_index) {
+        _cached_published_index = _published_index.load(std::memory_order_acquire);
+    }
+
+    const auto dispatch_count = std::min(_cached_published_index - read_index, max_event_count);
+
+    // Frees every dispatched slot with a single store, also when a handler throws, so that no
+    // event is dispatched twice
+    struct ConsumeGuard {
+        SpscChannel& channel;
+        std::size_t read_index;
+
+        ~ConsumeGuard()
+        {
+            channel._read_index.store(read_index, std::memory_order_release);
+        }
+    };
+
+    struct DestroyGuard {
+        EVENT_TYPE* slot;
+
+        ~DestroyGuard()
+        {
+            std::destroy_at(slot);
+        }
+    };
+
+    ConsumeGuard consume_guard { *this, read_index };
+
+    for (std::size_t event_index = 0; event_index < dispatch_count; ++event_index) {
+        const DestroyGuard destroy_guard { _get_slot(consume_guard.read_index++) };
+        event_dispatcher.dispatch(std::as_const(*destroy_guard.slot));
+    }
+
+    return dispatch_count;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline std::optional<EVENT_TYPE> SpscChannel<EVENT_TYPE>::try_pop()
+{
+    const auto read_index = _read_index.load(std::memory_order_relaxed);
+
+    if (read_index == _cached_published_index) {
+        _cached_published_index = _published_index.load(std::memory_order_acquire);
+
+        if (read_index == _cached_published_index) {
+            return std::nullopt;
+        }
+    }
+
+    const auto event_slot = _get_slot(read_index);
+    std::optional<EVENT_TYPE> event { std::move(*event_slot) };
+    std::destroy_at(event_slot);
+
+    _read_index.store(read_index + 1, std::memory_order_release);
+
+    return event;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline std::size_t SpscChannel<EVENT_TYPE>::get_capacity() const
+{
+    return _index_mask + 1;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline EVENT_TYPE* SpscChannel<EVENT_TYPE>::_get_slot(std::size_t index) const
+{
+    return _slot_list + (index & _index_mask);
+}
+
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline SpscChannelForwarder<EVENT_TYPE>::SpscChannelForwarder(SpscChannel<EVENT_TYPE>& channel, std::size_t batch_size)
+    : _channel(channel)
+    , _batch_size(std::max<std::size_t>(batch_size, 1))
+{
+}
+
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline void SpscChannelForwarder<EVENT_TYPE>::handle_event(const EVENT_TYPE& event)
+{
+    if (!_channel.try_write(event)) {
+        // The consumer can only make room for events it can see
+        flush();
+
+        while (!_channel.try_write(event)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (++_unpublished_count >= _batch_size) {
+        flush();
+    }
+}
+
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline void SpscChannelForwarder<EVENT_TYPE>::flush()
+{
+    _channel.publish();
+    _unpublished_count = 0;
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,234 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "bounded_queue.h"
+#include "shared/dispatchula_type_info.h"
+#include "thread_pool.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+
+namespace dispatch {
+
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicEventDispatcher;
+
+
+/**
+ * A serial mailbox drained by a ThreadPool. Tasks posted to a strand run one at a time, in
+ * the order they were posted, so whatever they touch needs no locking of its own. Different
+ * strands run in parallel on different pool threads.
+ *
+ * The mailbox holds at most `mailbox_capacity` tasks. `overflow_policy` decides what happens
+ * when posting to a full mailbox, and `get_mailbox_metrics` reports its depth, high water
+ * mark and drop counts.
+ *
+ * Subscribers bound to a strand with `EventDispatcher::set_strand` have their events handled
+ * on it instead of inside `EventDispatcher::dispatch`.
+ *
+ * Refer to the "Strands" section of `README.md` for example usage.
+ */
+class Strand {
+
+public:
+
+    /**
+     * The most tasks run per pool job before the strand yields its thread to other strands.
+     */
+    static constexpr std::size_t DRAIN_BATCH_SIZE = 64;
+    static constexpr std::size_t DEFAULT_MAILBOX_CAPACITY = 4096;
+
+    explicit Strand(ThreadPool& thread_pool, std::size_t mailbox_capacity = DEFAULT_MAILBOX_CAPACITY, OverflowPolicy overflow_policy = OverflowPolicy::BLOCK);
+    ~Strand();
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    /**
+     * Returns false only if `task` was dropped because the mailbox is full.
+     *
+     * Under OverflowPolicy::BLOCK, a task run by this strand must not post to this strand,
+     * as it could wait forever for room in its own mailbox.
+     */
+    bool post(std::function<void()> task);
+
+    /**
+     * Blocks until every task posted so far has run.
+     */
+    void wait_idle();
+
+    std::size_t get_backlog() const;
+    QueueMetrics get_mailbox_metrics() const;
+
+private:
+
+    template<class, class, class>
+    friend class BasicEventDispatcher;
+
+    struct _StrandTask_ {
+        const void* subscriber;
+        TypeId type_id;
+        std::function<void()> run;
+    };
+
+    bool _post(const void* subscriber, TypeId type_id, std::function<void()> task);
+    void _forget(const void* subscriber, TypeId type_id);
+    void _wait_until_not_running(const void* subscriber, TypeId type_id);
+    void _drain();
+
+    ThreadPool& _thread_pool;
+
+    BoundedQueue<_StrandTask_> _mailbox;
+
+    std::mutex _schedule_mutex {};
+    std::condition_variable _idle_condition {};
+    std::condition_variable _task_done_condition {};
+    bool _scheduled = false;
+
+    // The task currently being run by `_drain`, guarded by `_schedule_mutex`
+    const void* _running_subscriber = nullptr;
+    TypeId _running_type_id {};
+    std::thread::id _running_thread {};
+};
+
+
+inline Strand::Strand(ThreadPool& thread_pool, std::size_t mailbox_capacity, OverflowPolicy overflow_policy)
+    : _thread_pool(thread_pool)
+    , _mailbox(mailbox_capacity, overflow_policy)
+{
+}
+
+inline Strand::~Strand()
+{
+    wait_idle();
+}
+
+inline bool Strand::post(std::function<void()> task)
+{
+    return _post(nullptr, TypeId {}, std::move(task));
+}
+
+inline void Strand::wait_idle()
+{
+    std::unique_lock lock { _schedule_mutex };
+    _idle_condition.wait(lock, [this] { return !_scheduled; });
+}
+
+inline std::size_t Strand::get_backlog() const
+{
+    return _mailbox.get_depth();
+}
+
+inline QueueMetrics Strand::get_mailbox_metrics() const
+{
+    return _mailbox.get_metrics();
+}
+
+inline bool Strand::_post(const void* subscriber, TypeId type_id, std::function<void()> task)
+{
+    if (!_mailbox.push({ subscriber, type_id, std::move(task) })) {
+        return false;
+    }
+
+    {
+        std::lock_guard lock { _schedule_mutex };
+
+        if (_scheduled) {
+            return true;
+        }
+
+        _scheduled = true;
+    }
+
+    _thread_pool.post([this] { _drain(); });
+
+    return true;
+}
+
+inline void Strand::_forget(const void* subscriber, TypeId type_id)
+{
+    _mailbox.erase_if([subscriber, type_id](const _StrandTask_& task) {
+        return task.subscriber == subscriber && task.type_id == type_id;
+    });
+}
+
+inline void Strand::_wait_until_not_running(const void* subscriber, TypeId type_id)
+{
+    std::unique_lock lock { _schedule_mutex };
+
+    // A task that unsubscribes its own subscriber would otherwise wait for itself
+    if (_running_thread == std::this_thread::get_id()) {
+        return;
+    }
+
+    _task_done_condition.wait(lock, [this, subscriber, type_id] {
+        return _running_subscriber != subscriber || _running_type_id != type_id;
+    });
+}
+
+inline void Strand::_drain()
+{
+    for (std::size_t task_count = 0; task_count < DRAIN_BATCH_SIZE; ++task_count) {
+        std::optional<_StrandTask_> task;
+
+        {
+            // Popping under the schedule lock means a task posted after the mailbox is found
+            // empty always sees `_scheduled` false, and schedules a new drain itself
+            std::lock_guard lock { _schedule_mutex };
+            task = _mailbox.try_pop();
+
+            if (!task.has_value()) {
+                _scheduled = false;
+                _idle_condition.notify_all();
+                return;
+            }
+
+            _running_subscriber = task->subscriber;
+            _running_type_id = task->type_id;
+            _running_thread = std::this_thread::get_id();
+        }
+
+        task->run();
+
+        {
+            std::lock_guard lock { _schedule_mutex };
+            _running_subscriber = nullptr;
+            _running_type_id = {};
+            _running_thread = {};
+        }
+
+        _task_done_condition.notify_all();
+    }
+
+    _thread_pool.post([this] { _drain(); });
+}
+
+
+} // namespace dispatch
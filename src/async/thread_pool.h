@@ -0,0 +1,131 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * A fixed set of worker threads that run posted jobs in the order they were posted.
+ *
+ * Used to drain Strands. The destructor finishes every job already posted before joining
+ * the worker threads.
+ */
+class ThreadPool {
+
+public:
+
+    explicit ThreadPool(std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency()));
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void post(std::function<void()> job);
+
+    std::size_t get_thread_count() const;
+
+private:
+
+    void _run_worker();
+
+    std::mutex _job_mutex {};
+    std::condition_variable _job_condition {};
+    std::deque<std::function<void()>> _job_queue {};
+    bool _stopping = false;
+
+    std::vector<std::thread> _worker_list {};
+};
+
+
+inline ThreadPool::ThreadPool(std::size_t thread_count)
+{
+    _worker_list.reserve(thread_count);
+
+    for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+        _worker_list.emplace_back([this] { _run_worker(); });
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock { _job_mutex };
+        _stopping = true;
+    }
+
+    _job_condition.notify_all();
+
+    for (auto& worker : _worker_list) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::post(std::function<void()> job)
+{
+    {
+        std::lock_guard lock { _job_mutex };
+        _job_queue.push_back(std::move(job));
+    }
+
+    _job_condition.notify_one();
+}
+
+inline std::size_t ThreadPool::get_thread_count() const
+{
+    return _worker_list.size();
+}
+
+inline void ThreadPool::_run_worker()
+{
+    while (true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock lock { _job_mutex };
+            _job_condition.wait(lock, [this] { return _stopping || !_job_queue.empty(); });
+
+            if (_job_queue.empty()) {
+                return;
+            }
+
+            job = std::move(_job_queue.front());
+            _job_queue.pop_front();
+        }
+
+        job();
+    }
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,186 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event_dispatcher.h"
+#include "shared/dispatchula_type_info.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * Collects events during one frame and dispatches them together at the end of it.
+ *
+ * Deferred events are stored in a contiguous bucket per event type. `dispatch_deferred`
+ * swaps to a second set of buckets, so events deferred by handlers while it runs are kept
+ * for the next call, then dispatches each type's bucket as one batch with
+ * `BasicEventDispatcher::dispatch_batch`. Types are dispatched in the order they were first
+ * deferred, and events of a type in the order they were deferred. Bucket storage is kept
+ * between frames, so deferring does not allocate once each bucket has grown to its peak.
+ *
+ * EVENT_DISPATCHER_TYPE is the BasicEventDispatcher configuration dispatched with, and is
+ * deduced from the constructor's argument. The queue is not thread safe.
+ *
+ * Refer to the "Deferred Event Queue" section of `README.md` for example usage.
+ */
+template<class EVENT_DISPATCHER_TYPE = EventDispatcher>
+class DeferredEventQueue {
+
+public:
+
+    explicit DeferredEventQueue(const EVENT_DISPATCHER_TYPE& event_dispatcher);
+
+    template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+    void defer(const EVENT_TYPE& event);
+
+    template<class EVENT_TYPE, class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+    void defer_emplace(ARGUMENT_TYPE_LIST&& ... argument_list);
+
+    /**
+     * Dispatches every event deferred since the last call, returning how many were dispatched.
+     */
+    std::size_t dispatch_deferred();
+
+    std::size_t get_deferred_count() const;
+
+private:
+
+    class _DeferredBucketBase_ {
+
+    public:
+
+        virtual ~_DeferredBucketBase_() = default;
+
+        virtual std::size_t dispatch_and_clear(const EVENT_DISPATCHER_TYPE& event_dispatcher) = 0;
+    };
+
+    template<class EVENT_TYPE>
+    class _DeferredBucket_ : public _DeferredBucketBase_ {
+
+    public:
+
+        std::size_t dispatch_and_clear(const EVENT_DISPATCHER_TYPE& event_dispatcher) override;
+
+        std::vector<EVENT_TYPE> event_list {};
+    };
+
+    using _BucketList_ = std::vector<std::unique_ptr<_DeferredBucketBase_>>;
+
+    template<class EVENT_TYPE>
+    std::vector<EVENT_TYPE>& _get_write_event_list();
+
+    const EVENT_DISPATCHER_TYPE& _event_dispatcher;
+
+    // Both buffers hold a bucket for every type at the same index
+    std::unordered_map<TypeId, std::size_t> _bucket_index_map {};
+    std::array<_BucketList_, 2> _buffer_list {};
+    std::size_t _write_buffer_index = 0;
+    std::size_t _deferred_count = 0;
+};
+
+
+template<class EVENT_DISPATCHER_TYPE>
+inline DeferredEventQueue<EVENT_DISPATCHER_TYPE>::DeferredEventQueue(const EVENT_DISPATCHER_TYPE& event_dispatcher)
+    : _event_dispatcher(event_dispatcher)
+{
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline void DeferredEventQueue<EVENT_DISPATCHER_TYPE>::defer(const EVENT_TYPE& event)
+{
+    _get_write_event_list<EVENT_TYPE>().push_back(event);
+    ++_deferred_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE, class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+inline void DeferredEventQueue<EVENT_DISPATCHER_TYPE>::defer_emplace(ARGUMENT_TYPE_LIST&& ... argument_list)
+{
+    _get_write_event_list<EVENT_TYPE>().emplace_back(std::forward<ARGUMENT_TYPE_LIST>(argument_list)...);
+    ++_deferred_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t DeferredEventQueue<EVENT_DISPATCHER_TYPE>::dispatch_deferred()
+{
+    auto& read_bucket_list = _buffer_list[_write_buffer_index];
+    _write_buffer_index ^= 1;
+    _deferred_count = 0;
+
+    std::size_t dispatched_count = 0;
+
+    // Indexed, as handlers deferring a new type add a bucket to both buffers
+    for (std::size_t bucket_index = 0; bucket_index < read_bucket_list.size(); ++bucket_index) {
+        dispatched_count += read_bucket_list[bucket_index]->dispatch_and_clear(_event_dispatcher);
+    }
+
+    return dispatched_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t DeferredEventQueue<EVENT_DISPATCHER_TYPE>::get_deferred_count() const
+{
+    return _deferred_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE>
+inline std::vector<EVENT_TYPE>& DeferredEventQueue<EVENT_DISPATCHER_TYPE>::_get_write_event_list()
+{
+    auto [bucket_index_iter, inserted] = _bucket_index_map.try_emplace(type_id_v<EVENT_TYPE>, _buffer_list[0].size());
+
+    if (inserted) {
+        for (auto& bucket_list : _buffer_list) {
+            bucket_list.push_back(std::make_unique<_DeferredBucket_<EVENT_TYPE>>());
+        }
+    }
+
+    auto& bucket = *_buffer_list[_write_buffer_index][bucket_index_iter->second];
+
+    return static_cast<_DeferredBucket_<EVENT_TYPE>&>(bucket).event_list;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE>
+inline std::size_t DeferredEventQueue<EVENT_DISPATCHER_TYPE>::_DeferredBucket_<EVENT_TYPE>::dispatch_and_clear(const EVENT_DISPATCHER_TYPE& event_dispatcher)
+{
+    const auto event_count = event_list.size();
+
+    event_dispatcher.dispatch_batch(std::span<const EVENT_TYPE>(event_list));
+    event_list.clear();
+
+    return event_count;
+}
+
+
+} // namespace dispatch
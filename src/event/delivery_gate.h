@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+
+
+namespace dispatch {
+
+
+enum class DeliveryMode {
+    EVERY_EVENT,
+    EVERY_NTH,
+    RATE_LIMITED,
+    DEBOUNCED,
+};
+
+/**
+ * Decides which of the events dispatched to a subscription are handled, as set by
+ * `EventDispatcher::set_delivery_gate`. Construct one with the static functions below.
+ *
+ * `every_nth` handles the first event and every `n`th event after it.
+ *
+ * `rate_limited` is a token bucket holding up to `burst_count` tokens, refilled by one token
+ * every `refill_interval`. Each event handled takes a token, and events dispatched while the
+ * bucket is empty are discarded.
+ *
+ * `debounced` handles only the latest event of a burst, once `quiet_period` has passed
+ * without another being dispatched. The latest event is kept by the dispatcher until
+ * `EventDispatcher::flush_debounced` is next called after the quiet period.
+ */
+struct DeliveryGate {
+    DeliveryMode mode = DeliveryMode::EVERY_EVENT;
+    std::uint32_t count = 1;
+    std::chrono::nanoseconds interval { 0 };
+
+    static DeliveryGate every_event();
+    static DeliveryGate every_nth(std::uint32_t n);
+    static DeliveryGate rate_limited(std::uint32_t burst_count, std::chrono::nanoseconds refill_interval);
+    static DeliveryGate debounced(std::chrono::nanoseconds quiet_period);
+};
+
+
+inline DeliveryGate DeliveryGate::every_event()
+{
+    return {};
+}
+
+inline DeliveryGate DeliveryGate::every_nth(std::uint32_t n)
+{
+    return { .mode = DeliveryMode::EVERY_NTH, .count = n };
+}
+
+inline DeliveryGate DeliveryGate::rate_limited(std::uint32_t burst_count, std::chrono::nanoseconds refill_interval)
+{
+    return { .mode = DeliveryMode::RATE_LIMITED, .count = burst_count, .interval = refill_interval };
+}
+
+inline DeliveryGate DeliveryGate::debounced(std::chrono::nanoseconds quiet_period)
+{
+    return { .mode = DeliveryMode::DEBOUNCED, .interval = quiet_period };
+}
+
+
+} // namespace dispatch
@@ -21,115 +21,1783 @@
 #pragma once
 
 
+#include "async/strand.h"
+#include "delivery_gate.h"
+#include "event_pipeline.h"
+#include "event_recorder.h"
+#include "event_tap.h"
 #include "event_subscriber.h"
+#include "latency_watchdog.h"
+#include "shared/dispatch_policies.h"
+#include "shared/dispatch_tracer.h"
+#include "shared/dispatchula_type_info.h"
 
 #include <algorithm>
-#include <map>
-#include <typeindex>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
 namespace dispatch {
 
 
-class EventDispatcher {
+/**
+ * Dispatches events to every subscriber to their type.
+ *
+ * THREADING_POLICY, STORAGE_POLICY and INSTRUMENTATION_POLICY select how subscriptions are
+ * guarded, how they are looked up, and what is recorded about each dispatch. Refer to
+ * `shared/dispatch_policies.h` for the available policies. `EventDispatcher` is the single
+ * threaded, hash map based configuration, traced by the DispatchTracer.
+ */
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicEventDispatcher {
 
 public:
 
-    void subscribe(_EventSubscriberBase_* subscriber);
+    BasicEventDispatcher() = default;
+
+    /**
+     * Allocates the dispatcher's subscriber lists and lookup table from `memory_resource`
+     * instead of the default memory resource. `memory_resource` must outlive this dispatcher.
+     */
+    explicit BasicEventDispatcher(std::pmr::memory_resource* memory_resource);
+
+    /**
+     * Returns false if any of the subscriber's event types could not be subscribed to, which
+     * only happens if its TypeId hash collides with another event type's.
+     */
+    bool subscribe(_EventSubscriberBase_* subscriber);
+
+    template<class STATIC_EVENT_SUBSCRIBER_TYPE> requires _is_static_event_subscriber_<STATIC_EVENT_SUBSCRIBER_TYPE>
+    bool subscribe(STATIC_EVENT_SUBSCRIBER_TYPE* subscriber);
 
     template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
-    void subscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber);
+    bool subscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber);
 
     void unsubscribe(_EventSubscriberBase_* subscriber);
 
+    template<class STATIC_EVENT_SUBSCRIBER_TYPE> requires _is_static_event_subscriber_<STATIC_EVENT_SUBSCRIBER_TYPE>
+    void unsubscribe(STATIC_EVENT_SUBSCRIBER_TYPE* subscriber);
+
     template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
     void unsubscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber);
 
+    /**
+     * Subscribes every subscriber in `subscriber_list`, in order, as `subscribe` would. Each
+     * event type's subscriber list is grown once for the whole batch, rather than once per
+     * subscriber. Returns false if any subscriber could not subscribe to any of its types.
+     */
+    template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+    bool subscribe_all(std::span<SUBSCRIBER_TYPE* const> subscriber_list);
+
+    /**
+     * Unsubscribes every subscriber in `subscriber_list`, as `unsubscribe` would, compacting
+     * each event type's subscriber list in a single pass for the whole batch.
+     */
+    template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+    void unsubscribe_all(std::span<SUBSCRIBER_TYPE* const> subscriber_list);
+
     template<class EVENT_TYPE>
     void dispatch(const EVENT_TYPE& event) const;
 
+    /**
+     * Constructs an EVENT_TYPE in place from `argument_list` and dispatches it, but only if
+     * anything is subscribed to EVENT_TYPE, EVENT_TYPE is sticky, or the event would be
+     * recorded or tapped. Otherwise the event is never constructed.
+     */
+    template<class EVENT_TYPE, class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+    void dispatch_emplace(ARGUMENT_TYPE_LIST&& ... argument_list) const;
+
+    /**
+     * Dispatches the EVENT_TYPE returned by `event_factory`, but only if the event would be
+     * constructed by `dispatch_emplace`. Otherwise `event_factory` is never called.
+     */
+    template<class EVENT_TYPE, class EVENT_FACTORY_TYPE> requires std::is_invocable_r_v<EVENT_TYPE, EVENT_FACTORY_TYPE>
+    void dispatch_lazy(EVENT_FACTORY_TYPE&& event_factory) const;
+
+    /**
+     * Dispatches every event in `event_list`, in order. Each subscriber handles the whole batch
+     * before the next subscriber handles any of it, so the subscriber list is walked once per
+     * batch rather than once per event.
+     */
+    template<class EVENT_TYPE>
+    void dispatch_batch(std::span<const EVENT_TYPE> event_list) const;
+
+    /**
+     * Returns true if anything is currently subscribed to EVENT_TYPE, in constant time.
+     */
+    template<class EVENT_TYPE>
+    bool has_subscribers() const;
+
+    /**
+     * Makes EVENT_TYPE sticky, or no longer sticky if `sticky` is false.
+     *
+     * The dispatcher keeps a copy of the last dispatched event of each sticky type, and delivers
+     * it to every new subscriber to that type as soon as it subscribes. Storage for the copy is
+     * allocated once, here, and reused by every dispatch. Returns false only if EVENT_TYPE's
+     * TypeId hash collides with another event type's.
+     */
+    template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+    bool set_sticky(bool sticky = true);
+
+    /**
+     * Discards the last dispatched event of sticky EVENT_TYPE, so it is not delivered to new
+     * subscribers until the next dispatch of EVENT_TYPE.
+     */
+    template<class EVENT_TYPE>
+    void clear_sticky_event();
+
+    /**
+     * Makes this dispatcher a child of `parent`, or stops it being a child if `parent` is
+     * nullptr. `parent` must outlive this dispatcher.
+     *
+     * A child dispatcher handles each event with its own subscribers first, then forwards it
+     * to the nearest ancestor that would handle it, skipping the others in constant time.
+     * Subscribers to a child are never added to its parent's subscriber lists, so they are
+     * all dropped at once when the child is destroyed. Returns false, and changes nothing, if
+     * `parent` is this dispatcher or a descendant of it.
+     */
+    bool set_parent(const BasicEventDispatcher* parent);
+
+    /**
+     * Passes every trivially copyable event dispatched to `recorder` before it is handled, or
+     * stops if `recorder` is nullptr. `recorder` must outlive this dispatcher.
+     */
+    void set_recorder(EventRecorder* recorder);
+
+    /**
+     * Passes every event dispatched, of any type, to `tap` before it is handled, until the tap
+     * is removed with `remove_tap`. `tap` must outlive this dispatcher or be removed first.
+     *
+     * While no tap is added, dispatching only checks that the tap list is empty.
+     */
+    void add_tap(EventTap* tap);
+    void remove_tap(EventTap* tap);
+
+    /**
+     * Reports every handler call that exceeds its subscription's latency budget to `watchdog`,
+     * or stops reporting if `watchdog` is nullptr. `watchdog` must outlive this dispatcher.
+     */
+    void set_watchdog(LatencyWatchdog* watchdog);
+
+    /**
+     * Sets the latency budget for the subscriber's current subscription to EVENT_TYPE. A budget
+     * of zero removes the budget. Returns false if the subscriber is not subscribed to EVENT_TYPE.
+     *
+     * Budgets are reset when the subscriber unsubscribes from EVENT_TYPE.
+     */
+    template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
+    bool set_latency_budget(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber, std::chrono::nanoseconds latency_budget);
+
+    /**
+     * Sets which EVENT_TYPEs dispatched to the subscriber's current subscription are handled.
+     * Refer to `DeliveryGate` for the available gates. Returns false if the subscriber is not
+     * subscribed to EVENT_TYPE, if `delivery_gate` is invalid, or if it is debounced and
+     * EVENT_TYPE is not copyable.
+     *
+     * Gates are reset when the subscriber unsubscribes from EVENT_TYPE.
+     */
+    template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
+    bool set_delivery_gate(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber, DeliveryGate delivery_gate);
+
+    /**
+     * Handles the latest event kept by each debounced subscription whose quiet period has
+     * passed by `now`. Returns the number of events handled.
+     */
+    std::size_t flush_debounced(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+
+    /**
+     * Binds all of the subscriber's current subscriptions to `strand`, or unbinds them if
+     * `strand` is nullptr. Returns false if the subscriber is not subscribed to anything.
+     *
+     * Events for a bound subscription are copied and handled on `strand` instead of inside
+     * `dispatch`, so the subscriber is never handling two events at once, even when events
+     * are dispatched from several threads. Events of non-copyable types are still handled
+     * inside `dispatch`. Bindings are reset when the subscriber unsubscribes, and events
+     * still waiting on `strand` are discarded. Unsubscribing also waits for any of the
+     * subscriber's handler calls already running on `strand` to return, unless called from
+     * that handler call, so the subscriber can be destroyed as soon as it is unsubscribed.
+     */
+    template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+    bool set_strand(SUBSCRIBER_TYPE* subscriber, Strand* strand);
+
+    /**
+     * Starts building a pipeline that transforms each dispatched EVENT_TYPE and dispatches the
+     * result, in place of a subscriber that does the same. The pipeline is owned by this
+     * dispatcher, and refers to it, so the dispatcher must not be moved once it has pipelines.
+     */
+    template<class EVENT_TYPE>
+    EventPipeline<BasicEventDispatcher, EVENT_TYPE, EVENT_TYPE, _IdentityPipelineStage_> on();
+
+    /**
+     * Unsubscribes and destroys the pipeline identified by `pipeline_handle`. Returns false if
+     * it has already been removed.
+     */
+    bool remove_pipeline(PipelineHandle pipeline_handle);
+
 private:
 
-    void _subscribe_to_type_id(_EventSubscriberBase_* subscriber, std::type_index type_id);
-    void _unsubscribe_from_type_id(_EventSubscriberBase_* subscriber, std::type_index type_id);
+    template<class, class, class, class>
+    friend class EventPipeline;
+
+    using _Mutex_ = typename THREADING_POLICY::mutex_type;
+    using _InstrumentationScope_ = typename INSTRUMENTATION_POLICY::scope_type;
+
+    struct _PlannedHandler_;
+
+    class _StickyEventBase_ {
+
+    public:
+
+        virtual ~_StickyEventBase_() = default;
+
+        virtual void deliver(const _EventHandler_& handler) const = 0;
+        virtual bool release(const BasicEventDispatcher& event_dispatcher, const _PlannedHandler_& planned_handler, std::chrono::steady_clock::time_point now) = 0;
+        virtual void clear() = 0;
+    };
+
+    template<class EVENT_TYPE>
+    class _StickyEvent_ : public _StickyEventBase_ {
+
+    public:
+
+        void store(const EVENT_TYPE& event);
+        void deliver(const _EventHandler_& handler) const override;
+        bool release(const BasicEventDispatcher& event_dispatcher, const _PlannedHandler_& planned_handler, std::chrono::steady_clock::time_point now) override;
+        void clear() override;
+
+    private:
+
+        std::optional<EVENT_TYPE> _last_event = std::nullopt;
+        mutable _Mutex_ _mutex {};
+    };
+
+    struct _DeliveryGateState_ {
+        DeliveryGate gate;
+        std::uint64_t event_count = 0;
+        std::uint32_t token_count = 0;
+        std::chrono::steady_clock::time_point last_time {};
+        std::unique_ptr<_StickyEventBase_> latest_event {};
+        _Mutex_ mutex {};
+    };
+
+    /**
+     * Everything that makes a subscription more than a handler call. Only allocated once one
+     * of these is set, and kept apart from the subscriber list, so that dispatch plans can
+     * refer to it while subscriptions are added or removed.
+     */
+    struct _SubscriptionState_ {
+        std::chrono::nanoseconds latency_budget { 0 };
+        mutable std::uint32_t violation_count = 0;
+        mutable bool demoted = false;
+        Strand* strand = nullptr;
+        std::unique_ptr<_DeliveryGateState_> gate {};
+    };
+
+    struct _EventSubscription_ {
+        const void* subscriber;
+        _EventHandler_ handler;
+        std::unique_ptr<_SubscriptionState_> state {};
+    };
+
+    // A strand that may still be running a handler call for a subscription just removed
+    struct _UnboundStrand_ {
+        Strand* strand;
+        const void* subscriber;
+        TypeId type_id;
+    };
+
+    /**
+     * One handler call in an event type's dispatch plan. `state` is only set for subscriptions
+     * that need more than a handler call, e.g. those with a latency budget. Plans never refer
+     * to the subscriber list itself, which may grow while a plan is being walked.
+     */
+    struct _PlannedHandler_ {
+        const void* subscriber;
+        _EventHandler_ handler;
+        const _SubscriptionState_* state;
+
+        // Set when unsubscribed by a handler while the plan is being walked
+        bool is_unsubscribed = false;
+    };
+
+    class _PipelineBase_ {
+
+    public:
+
+        virtual ~_PipelineBase_() = default;
+    };
+
+    struct _EventTypeEntry_ {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        explicit _EventTypeEntry_(const allocator_type& allocator);
+
+        std::pmr::vector<_EventSubscription_> subscriber_list;
+        std::unique_ptr<_StickyEventBase_> sticky_event {};
+
+        // Rebuilt from `subscriber_list` by the first dispatch after any subscription changes
+        mutable std::pmr::vector<_PlannedHandler_> dispatch_plan;
+        mutable std::uint64_t plan_version = 0;
+        mutable _Mutex_ plan_mutex {};
+
+        // The number of dispatches walking `dispatch_plan`, only counted when single threaded
+        mutable std::uint32_t dispatch_depth = 0;
+
+        // Removed by handlers while `dispatch_plan` was being walked, and destroyed once it is not
+        mutable std::pmr::vector<std::unique_ptr<_SubscriptionState_>> retired_state_list;
+        mutable std::pmr::vector<std::unique_ptr<_PipelineBase_>> retired_pipeline_list;
+    };
+
+    /**
+     * Counts a dispatch walking an entry's plan for as long as it lives. While any are, the
+     * plan is not rebuilt, and whatever it refers to is not destroyed, so handlers can change
+     * subscriptions and dispatch the same event type without pulling it from under the walk.
+     */
+    class _PlanWalkScope_ {
+
+    public:
+
+        explicit _PlanWalkScope_(const _EventTypeEntry_& entry);
+        ~_PlanWalkScope_();
+
+        _PlanWalkScope_(const _PlanWalkScope_&) = delete;
+        _PlanWalkScope_& operator=(const _PlanWalkScope_&) = delete;
+
+    private:
+
+        const _EventTypeEntry_& _entry;
+    };
 
-    std::map<std::type_index, std::vector<_EventSubscriberBase_*>> _subscriber_map {};
+    template<class EVENT_TYPE, class FUNCTION_TYPE>
+    class _Pipeline_ : public _PipelineBase_ {
+
+    public:
+
+        explicit _Pipeline_(FUNCTION_TYPE function);
+
+        static void _handle_event(void* context, const void* event);
+
+    private:
+
+        FUNCTION_TYPE _function;
+    };
+
+    template<class EVENT_TYPE>
+    const _EventTypeEntry_* _find_entry() const;
+
+    template<class EVENT_TYPE>
+    static void _store_sticky_event(const _EventTypeEntry_& entry, const EVENT_TYPE& event);
+
+    template<class EVENT_TYPE>
+    void _observe_event(const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE>
+    bool _is_event_wanted(const _EventTypeEntry_* entry) const;
+
+    template<class EVENT_TYPE>
+    bool _is_event_wanted_by_parent() const;
+
+    template<class EVENT_TYPE>
+    void _dispatch_to_entry(const _EventTypeEntry_* entry, const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE>
+    void _forward_to_parent(const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE>
+    void _dispatch_forwarded(const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE, class FUNCTION_TYPE>
+    PipelineHandle _add_pipeline(FUNCTION_TYPE function);
+
+    const std::pmr::vector<_PlannedHandler_>& _get_dispatch_plan(const _EventTypeEntry_& entry) const;
+
+    template<class EVENT_TYPE>
+    void _dispatch_to_plan(const _EventTypeEntry_& entry, const EVENT_TYPE& event) const;
+
+    static bool _is_walking_plan(const _EventTypeEntry_& entry);
+
+    template<class EVENT_TYPE>
+    void _handle_event(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE>
+    void _deliver_event(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const;
+
+    template<class EVENT_TYPE>
+    static bool _pass_delivery_gate(_DeliveryGateState_& gate_state, const EVENT_TYPE& event);
+
+    static bool _is_quiet_period_over(_DeliveryGateState_& gate_state, std::chrono::steady_clock::time_point now);
+
+    template<class EVENT_TYPE>
+    static void _post_to_strand(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event);
+
+    template<class EVENT_TYPE>
+    void _handle_event_within_budget(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const;
+
+    static bool _is_demoted(const _SubscriptionState_& state);
+    static bool _demote(const _SubscriptionState_& state);
+    static std::uint32_t _count_violation(const _SubscriptionState_& state);
+
+    static _SubscriptionState_& _get_or_create_state(_EventSubscription_& subscription);
+
+    template<class SUBSCRIBER_TYPE>
+    static const void* _get_subscriber_key(SUBSCRIBER_TYPE* subscriber);
+
+    template<class EVENT_TYPE, class SUBSCRIBER_TYPE>
+    _EventSubscription_* _find_subscription(SUBSCRIBER_TYPE* subscriber);
+
+    template<class EVENT_TYPE, class SUBSCRIBER_TYPE>
+    static _EventHandler_ _get_event_handler(SUBSCRIBER_TYPE* subscriber);
+
+    template<class SUBSCRIBER_TYPE>
+    static std::span<const TypeId> _get_type_id_list(SUBSCRIBER_TYPE* subscriber);
+
+    template<class SUBSCRIBER_TYPE>
+    static _EventHandler_ _get_type_handler(SUBSCRIBER_TYPE* subscriber, std::size_t type_index);
+
+    _EventTypeEntry_* _find_or_create_entry(TypeId type_id);
+    _EventTypeEntry_* _lock_and_find_or_create_entry(TypeId type_id);
+
+    bool _subscribe_to_type_id(const void* subscriber, _EventHandler_ handler, TypeId type_id);
+    void _deliver_sticky_event(TypeId type_id, const _EventHandler_& handler) const;
+    void _unsubscribe_from_type_id(const void* subscriber, TypeId type_id, std::vector<_UnboundStrand_>& unbound_strand_list);
+
+    template<class PREDICATE_TYPE>
+    void _unsubscribe_from_type_id_if(TypeId type_id, PREDICATE_TYPE is_unsubscribing, std::vector<_UnboundStrand_>& unbound_strand_list);
+
+    static void _wait_for_unbound_strands(const std::vector<_UnboundStrand_>& unbound_strand_list);
+
+    typename STORAGE_POLICY::template map_type<TypeId, _EventTypeEntry_> _subscriber_map {};
+    std::uint64_t _subscription_version = 0;
+    const BasicEventDispatcher* _parent = nullptr;
+    EventRecorder* _recorder = nullptr;
+    std::pmr::vector<EventTap*> _tap_list {};
+    LatencyWatchdog* _watchdog = nullptr;
+    std::pmr::vector<std::unique_ptr<_PipelineBase_>> _pipeline_list {};
+    mutable _Mutex_ _mutex {};
 };
 
 
-inline void EventDispatcher::subscribe(_EventSubscriberBase_* subscriber)
+using EventDispatcher = BasicEventDispatcher<SingleThreaded, HashStorage, TracingInstrumentation>;
+
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::BasicEventDispatcher(std::pmr::memory_resource* memory_resource)
+    : _subscriber_map(memory_resource)
+    , _tap_list(memory_resource)
+    , _pipeline_list(memory_resource)
+{}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(_EventSubscriberBase_* subscriber)
+{
+    const auto type_id_list = subscriber->_get_event_type_id_list();
+
+    bool subscribe_success = true;
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+            auto handler = subscriber->_get_event_handler(type_index);
+            subscribe_success &= _subscribe_to_type_id(subscriber, handler, type_id_list[type_index]);
+        }
+    }
+
+    for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+        _deliver_sticky_event(type_id_list[type_index], subscriber->_get_event_handler(type_index));
+    }
+
+    return subscribe_success;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class STATIC_EVENT_SUBSCRIBER_TYPE> requires _is_static_event_subscriber_<STATIC_EVENT_SUBSCRIBER_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(STATIC_EVENT_SUBSCRIBER_TYPE* subscriber)
 {
-    const std::vector<std::type_index>& type_id_list = subscriber->_get_event_type_id_list();
+    auto static_subscriber = static_cast<_static_event_subscriber_base_t_<STATIC_EVENT_SUBSCRIBER_TYPE>*>(subscriber);
+    const auto& type_id_list = static_subscriber->_event_type_id_list;
+
+    bool subscribe_success = true;
+
+    {
+        const std::unique_lock lock { _mutex };
 
-    for (auto type_id : type_id_list) {
-        _subscribe_to_type_id(subscriber, type_id);
+        for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+            auto handler = static_subscriber->_get_event_handler(type_index);
+            subscribe_success &= _subscribe_to_type_id(static_subscriber, handler, type_id_list[type_index]);
+        }
     }
+
+    for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+        _deliver_sticky_event(type_id_list[type_index], static_subscriber->_get_event_handler(type_index));
+    }
+
+    return subscribe_success;
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
-inline void EventDispatcher::subscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber)
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber)
+{
+    const auto handler = _get_event_handler<EVENT_TYPE>(subscriber);
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        if (!_subscribe_to_type_id(_get_subscriber_key(subscriber), handler, type_id_v<EVENT_TYPE>)) {
+            return false;
+        }
+    }
+
+    _deliver_sticky_event(type_id_v<EVENT_TYPE>, handler);
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(_EventSubscriberBase_* subscriber)
 {
-    _subscribe_to_type_id(subscriber, typeid(EVENT_TYPE));
+    const auto type_id_list = subscriber->_get_event_type_id_list();
+
+    std::vector<_UnboundStrand_> unbound_strand_list;
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        for (const auto& type_id : type_id_list) {
+            _unsubscribe_from_type_id(subscriber, type_id, unbound_strand_list);
+        }
+    }
+
+    _wait_for_unbound_strands(unbound_strand_list);
 }
 
-inline void EventDispatcher::unsubscribe(_EventSubscriberBase_* subscriber)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class STATIC_EVENT_SUBSCRIBER_TYPE> requires _is_static_event_subscriber_<STATIC_EVENT_SUBSCRIBER_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(STATIC_EVENT_SUBSCRIBER_TYPE* subscriber)
 {
-    const std::vector<std::type_index>& type_id_list = subscriber->_get_event_type_id_list();
+    auto static_subscriber = static_cast<_static_event_subscriber_base_t_<STATIC_EVENT_SUBSCRIBER_TYPE>*>(subscriber);
 
-    for (auto type_id : type_id_list) {
-        _unsubscribe_from_type_id(subscriber, type_id);
+    std::vector<_UnboundStrand_> unbound_strand_list;
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        for (const auto& type_id : static_subscriber->_event_type_id_list) {
+            _unsubscribe_from_type_id(static_subscriber, type_id, unbound_strand_list);
+        }
     }
+
+    _wait_for_unbound_strands(unbound_strand_list);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
-inline void EventDispatcher::unsubscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber)
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber)
+{
+    std::vector<_UnboundStrand_> unbound_strand_list;
+
+    {
+        const std::unique_lock lock { _mutex };
+        _unsubscribe_from_type_id(_get_subscriber_key(subscriber), type_id_v<EVENT_TYPE>, unbound_strand_list);
+    }
+
+    _wait_for_unbound_strands(unbound_strand_list);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe_all(std::span<SUBSCRIBER_TYPE* const> subscriber_list)
+{
+    struct BatchEntry {
+        TypeId type_id;
+        _EventTypeEntry_* entry;
+        std::size_t subscriber_count;
+    };
+
+    // Few event types are shared by a batch, so a linear search beats a map lookup
+    std::vector<BatchEntry> batch_entry_list;
+
+    const auto find_batch_entry = [&batch_entry_list](TypeId type_id) {
+        return std::find_if(batch_entry_list.begin(), batch_entry_list.end(), [type_id](const BatchEntry& batch_entry) {
+            return batch_entry.type_id == type_id;
+        });
+    };
+
+    for (const auto subscriber : subscriber_list) {
+        for (const auto type_id : _get_type_id_list(subscriber)) {
+            const auto batch_entry_iter = find_batch_entry(type_id);
+
+            if (batch_entry_iter == batch_entry_list.end()) {
+                batch_entry_list.push_back({ type_id, nullptr, 1 });
+            }
+
+            else {
+                ++batch_entry_iter->subscriber_count;
+            }
+        }
+    }
+
+    bool subscribe_success = true;
+    bool has_sticky_event = false;
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        for (auto& batch_entry : batch_entry_list) {
+            batch_entry.entry = _find_or_create_entry(batch_entry.type_id);
+
+            if (batch_entry.entry == nullptr) {
+                subscribe_success = false;
+                continue;
+            }
+
+            auto& entry_subscriber_list = batch_entry.entry->subscriber_list;
+            entry_subscriber_list.reserve(entry_subscriber_list.size() + batch_entry.subscriber_count);
+            has_sticky_event |= batch_entry.entry->sticky_event != nullptr;
+        }
+
+        for (const auto subscriber : subscriber_list) {
+            const auto type_id_list = _get_type_id_list(subscriber);
+
+            for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+                const auto entry = find_batch_entry(type_id_list[type_index])->entry;
+
+                if (entry != nullptr) {
+                    entry->subscriber_list.push_back({ _get_subscriber_key(subscriber), _get_type_handler(subscriber, type_index) });
+                }
+            }
+        }
+
+        ++_subscription_version;
+    }
+
+    if (has_sticky_event) {
+        for (const auto subscriber : subscriber_list) {
+            const auto type_id_list = _get_type_id_list(subscriber);
+
+            for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+                _deliver_sticky_event(type_id_list[type_index], _get_type_handler(subscriber, type_index));
+            }
+        }
+    }
+
+    return subscribe_success;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe_all(std::span<SUBSCRIBER_TYPE* const> subscriber_list)
 {
-    _unsubscribe_from_type_id(subscriber, typeid(EVENT_TYPE));
+    std::vector<const void*> subscriber_key_list;
+    std::vector<TypeId> type_id_list;
+
+    subscriber_key_list.reserve(subscriber_list.size());
+
+    for (const auto subscriber : subscriber_list) {
+        subscriber_key_list.push_back(_get_subscriber_key(subscriber));
+
+        for (const auto type_id : _get_type_id_list(subscriber)) {
+            if (std::find(type_id_list.begin(), type_id_list.end(), type_id) == type_id_list.end()) {
+                type_id_list.push_back(type_id);
+            }
+        }
+    }
+
+    std::sort(subscriber_key_list.begin(), subscriber_key_list.end(), std::less<> {});
+
+    std::vector<_UnboundStrand_> unbound_strand_list;
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        for (const auto type_id : type_id_list) {
+            _unsubscribe_from_type_id_if(type_id, [&subscriber_key_list](const void* subscriber) {
+                return std::binary_search(subscriber_key_list.begin(), subscriber_key_list.end(), subscriber, std::less<> {});
+            }, unbound_strand_list);
+        }
+    }
+
+    _wait_for_unbound_strands(unbound_strand_list);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class EVENT_TYPE>
-inline void EventDispatcher::dispatch(const EVENT_TYPE& event) const
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const EVENT_TYPE& event) const
 {
-    const auto event_subscribers_iter = _subscriber_map.find(typeid(event));
+    const std::shared_lock lock { _mutex };
+    _dispatch_to_entry(_find_entry<EVENT_TYPE>(), event);
+}
 
-    if (event_subscribers_iter == _subscriber_map.end()) {
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<EVENT_TYPE, ARGUMENT_TYPE_LIST...>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch_emplace(ARGUMENT_TYPE_LIST&& ... argument_list) const
+{
+    const std::shared_lock lock { _mutex };
+    const auto entry = _find_entry<EVENT_TYPE>();
+
+    if (!_is_event_wanted<EVENT_TYPE>(entry) && !_is_event_wanted_by_parent<EVENT_TYPE>()) {
+        return;
+    }
+
+    const EVENT_TYPE event(std::forward<ARGUMENT_TYPE_LIST>(argument_list)...);
+    _dispatch_to_entry(entry, event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class EVENT_FACTORY_TYPE> requires std::is_invocable_r_v<EVENT_TYPE, EVENT_FACTORY_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch_lazy(EVENT_FACTORY_TYPE&& event_factory) const
+{
+    const std::shared_lock lock { _mutex };
+    const auto entry = _find_entry<EVENT_TYPE>();
+
+    if (!_is_event_wanted<EVENT_TYPE>(entry) && !_is_event_wanted_by_parent<EVENT_TYPE>()) {
         return;
     }
 
-    const auto& subscriber_list = event_subscribers_iter->second;
+    const EVENT_TYPE event = std::invoke(std::forward<EVENT_FACTORY_TYPE>(event_factory));
+    _dispatch_to_entry(entry, event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch_batch(std::span<const EVENT_TYPE> event_list) const
+{
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<EVENT_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+
+    for (const auto& event : event_list) {
+        _observe_event(event);
+    }
+
+    const auto entry = _find_entry<EVENT_TYPE>();
+
+    if (entry != nullptr && !event_list.empty()) {
+        _store_sticky_event(*entry, event_list.back());
+
+        const auto& dispatch_plan = _get_dispatch_plan(*entry);
+        const _PlanWalkScope_ plan_walk_scope { *entry };
+
+        for (const auto& planned_handler : dispatch_plan) {
+            // Checked before every event, as a handler may unsubscribe part way through the batch
+            for (const auto& event : event_list) {
+                if (planned_handler.is_unsubscribed) [[unlikely]] {
+                    break;
+                }
 
-    for (auto& subscriber : subscriber_list) {
-        auto sub_subscriber = dynamic_cast<_SingleEventSubscriber_<EVENT_TYPE>*>(subscriber);
-        sub_subscriber->handle_event(event);
+                if (planned_handler.state != nullptr) {
+                    _handle_event(planned_handler, event);
+                    continue;
+                }
+
+                const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, planned_handler.subscriber };
+                planned_handler.handler.function(planned_handler.handler.context, &event);
+            }
+        }
+    }
+
+    if (_is_event_wanted_by_parent<EVENT_TYPE>()) {
+        _parent->dispatch_batch(event_list);
     }
 }
 
-inline void EventDispatcher::_subscribe_to_type_id(_EventSubscriberBase_* subscriber, std::type_index type_id)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::has_subscribers() const
 {
-    auto event_subscribers_iter = _subscriber_map.find(type_id);
+    const std::shared_lock lock { _mutex };
+    const auto entry = _find_entry<EVENT_TYPE>();
+    return entry != nullptr && !entry->subscriber_list.empty();
+}
 
-    if (event_subscribers_iter == _subscriber_map.end()) {
-        _subscriber_map.insert({type_id, {subscriber}});
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_sticky(bool sticky)
+{
+    const std::unique_lock lock { _mutex };
+    const auto entry = _find_or_create_entry(type_id_v<EVENT_TYPE>);
+
+    if (entry == nullptr) {
+        return false;
     }
 
-    else {
-        auto& subscriber_list = event_subscribers_iter->second;
-        subscriber_list.push_back(subscriber);
+    if (!sticky) {
+        entry->sticky_event.reset();
+    }
+
+    else if (!entry->sticky_event) {
+        entry->sticky_event = std::make_unique<_StickyEvent_<EVENT_TYPE>>();
     }
+
+    return true;
 }
 
-inline void EventDispatcher::_unsubscribe_from_type_id(_EventSubscriberBase_* subscriber, std::type_index type_id)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::clear_sticky_event()
 {
-    auto event_subscribers_iter = _subscriber_map.find(type_id);
+    const std::unique_lock lock { _mutex };
+    const auto event_subscribers_iter = _subscriber_map.find(type_id_v<EVENT_TYPE>);
+
+    if (event_subscribers_iter != _subscriber_map.end() && event_subscribers_iter->second.sticky_event) {
+        event_subscribers_iter->second.sticky_event->clear();
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::on() -> EventPipeline<BasicEventDispatcher, EVENT_TYPE, EVENT_TYPE, _IdentityPipelineStage_>
+{
+    return { *this, _IdentityPipelineStage_ {} };
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::remove_pipeline(PipelineHandle pipeline_handle)
+{
+    const std::unique_lock lock { _mutex };
+
+    const auto pipeline_iter = std::find_if(_pipeline_list.begin(), _pipeline_list.end(), [&pipeline_handle](const auto& pipeline) {
+        return pipeline.get() == pipeline_handle.pipeline;
+    });
+
+    if (pipeline_iter == _pipeline_list.end()) {
+        return false;
+    }
+
+    // Pipelines cannot be bound to strands, so there is no handler call to wait for
+    std::vector<_UnboundStrand_> unbound_strand_list;
+
+    _unsubscribe_from_type_id(pipeline_handle.pipeline, pipeline_handle.input_type_id, unbound_strand_list);
+
+    // A handler removing a pipeline, possibly its own, cannot destroy it under the dispatch
+    const auto event_subscribers_iter = _subscriber_map.find(pipeline_handle.input_type_id);
+
+    if (event_subscribers_iter != _subscriber_map.end() && _is_walking_plan(event_subscribers_iter->second)) {
+        event_subscribers_iter->second.retired_pipeline_list.push_back(std::move(*pipeline_iter));
+    }
+
+    _pipeline_list.erase(pipeline_iter);
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_find_entry() const -> const _EventTypeEntry_*
+{
+    const auto event_subscribers_iter = _subscriber_map.find(type_id_v<EVENT_TYPE>);
 
     if (event_subscribers_iter == _subscriber_map.end()) {
-        return;
+        return nullptr;
     }
 
-    else {
-        auto& subscriber_list = event_subscribers_iter->second;
-        subscriber_list.erase(std::remove(subscriber_list.begin(), subscriber_list.end(), subscriber), subscriber_list.end());
+    return &event_subscribers_iter->second;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_store_sticky_event(const _EventTypeEntry_& entry, const EVENT_TYPE& event)
+{
+    if constexpr (std::is_copy_constructible_v<EVENT_TYPE>) {
+        if (entry.sticky_event) {
+            static_cast<_StickyEvent_<EVENT_TYPE>*>(entry.sticky_event.get())->store(event);
+        }
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_observe_event(const EVENT_TYPE& event) const
+{
+    if constexpr (std::is_trivially_copyable_v<EVENT_TYPE>) {
+        if (_recorder != nullptr) {
+            _recorder->record_event(type_id_v<EVENT_TYPE>, std::as_bytes(std::span { &event, 1 }));
+        }
+    }
+
+    if (!_tap_list.empty()) [[unlikely]] {
+        std::span<const std::byte> event_bytes {};
+
+        if constexpr (std::is_trivially_copyable_v<EVENT_TYPE>) {
+            event_bytes = std::as_bytes(std::span { &event, 1 });
+        }
+
+        const TappedEvent tapped_event { type_id_v<EVENT_TYPE>, type_name_v<EVENT_TYPE>, &event, event_bytes };
+
+        for (const auto tap : _tap_list) {
+            tap->tap_event(tapped_event);
+        }
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_is_event_wanted(const _EventTypeEntry_* entry) const
+{
+    if ((std::is_trivially_copyable_v<EVENT_TYPE> && _recorder != nullptr) || !_tap_list.empty()) {
+        return true;
+    }
+
+    return entry != nullptr && (!entry->subscriber_list.empty() || entry->sticky_event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_is_event_wanted_by_parent() const
+{
+    if (_parent == nullptr) {
+        return false;
+    }
+
+    const std::shared_lock parent_lock { _parent->_mutex };
+
+    return _parent->template _is_event_wanted<EVENT_TYPE>(_parent->template _find_entry<EVENT_TYPE>())
+           || _parent->template _is_event_wanted_by_parent<EVENT_TYPE>();
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_EventTypeEntry_::_EventTypeEntry_(const allocator_type& allocator)
+    : subscriber_list(allocator)
+    , dispatch_plan(allocator)
+    , retired_state_list(allocator)
+    , retired_pipeline_list(allocator)
+{}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_PlanWalkScope_::_PlanWalkScope_(const _EventTypeEntry_& entry)
+    : _entry(entry)
+{
+    if constexpr (!THREADING_POLICY::is_thread_safe) {
+        ++_entry.dispatch_depth;
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_PlanWalkScope_::~_PlanWalkScope_()
+{
+    if constexpr (!THREADING_POLICY::is_thread_safe) {
+        if (--_entry.dispatch_depth == 0) {
+            _entry.retired_state_list.clear();
+            _entry.retired_pipeline_list.clear();
+        }
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_StickyEvent_<EVENT_TYPE>::store(const EVENT_TYPE& event)
+{
+    const std::unique_lock lock { _mutex };
+
+    if constexpr (std::is_copy_assignable_v<EVENT_TYPE>) {
+        if (_last_event.has_value()) {
+            *_last_event = event;
+            return;
+        }
+    }
+
+    _last_event.emplace(event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_StickyEvent_<EVENT_TYPE>::deliver(const _EventHandler_& handler) const
+{
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        std::optional<EVENT_TYPE> last_event;
+
+        {
+            const std::unique_lock lock { _mutex };
+            last_event = _last_event;
+        }
+
+        if (last_event.has_value()) {
+            const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, handler.context };
+            handler.function(handler.context, &*last_event);
+        }
+    }
+
+    else if (_last_event.has_value()) {
+        const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, handler.context };
+        handler.function(handler.context, &*_last_event);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_StickyEvent_<EVENT_TYPE>::release(const BasicEventDispatcher& event_dispatcher, const _PlannedHandler_& planned_handler, std::chrono::steady_clock::time_point now)
+{
+    std::optional<EVENT_TYPE> last_event;
+
+    {
+        // Checked and taken under one lock, so an event kept after the check is never taken early
+        const std::unique_lock gate_lock { planned_handler.state->gate->mutex };
+
+        if (!_is_quiet_period_over(*planned_handler.state->gate, now)) {
+            return false;
+        }
+
+        const std::unique_lock lock { _mutex };
+        last_event.swap(_last_event);
+    }
+
+    if (!last_event.has_value()) {
+        return false;
+    }
+
+    event_dispatcher._deliver_event(planned_handler, *last_event);
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_StickyEvent_<EVENT_TYPE>::clear()
+{
+    const std::unique_lock lock { _mutex };
+    _last_event.reset();
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_dispatch_to_entry(const _EventTypeEntry_* entry, const EVENT_TYPE& event) const
+{
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<EVENT_TYPE>, nullptr };
+
+    _observe_event(event);
+
+    if (entry != nullptr) {
+        _store_sticky_event(*entry, event);
+        _dispatch_to_plan(*entry, event);
+    }
+
+    _forward_to_parent(event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_forward_to_parent(const EVENT_TYPE& event) const
+{
+    if (_parent != nullptr) {
+        _parent->_dispatch_forwarded(event);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_dispatch_forwarded(const EVENT_TYPE& event) const
+{
+    const std::shared_lock lock { _mutex };
+    const auto entry = _find_entry<EVENT_TYPE>();
+
+    // Ancestors that would not handle the event are skipped without a dispatch of their own
+    if (_is_event_wanted<EVENT_TYPE>(entry)) {
+        _dispatch_to_entry(entry, event);
+    }
+
+    else {
+        _forward_to_parent(event);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class FUNCTION_TYPE>
+inline PipelineHandle BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_add_pipeline(FUNCTION_TYPE function)
+{
+    auto pipeline = std::make_unique<_Pipeline_<EVENT_TYPE, FUNCTION_TYPE>>(std::move(function));
+    const PipelineHandle pipeline_handle { pipeline.get(), type_id_v<EVENT_TYPE> };
+    const _EventHandler_ handler { pipeline.get(), &_Pipeline_<EVENT_TYPE, FUNCTION_TYPE>::_handle_event };
+
+    {
+        const std::unique_lock lock { _mutex };
+
+        if (!_subscribe_to_type_id(pipeline.get(), handler, type_id_v<EVENT_TYPE>)) {
+            return {};
+        }
+
+        _pipeline_list.push_back(std::move(pipeline));
+    }
+
+    _deliver_sticky_event(type_id_v<EVENT_TYPE>, handler);
+
+    return pipeline_handle;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class FUNCTION_TYPE>
+inline BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_Pipeline_<EVENT_TYPE, FUNCTION_TYPE>::_Pipeline_(FUNCTION_TYPE function)
+    : _function(std::move(function))
+{}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class FUNCTION_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_Pipeline_<EVENT_TYPE, FUNCTION_TYPE>::_handle_event(void* context, const void* event)
+{
+    static_cast<_Pipeline_*>(context)->_function(*static_cast<const EVENT_TYPE*>(event));
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_dispatch_plan(const _EventTypeEntry_& entry) const -> const std::pmr::vector<_PlannedHandler_>&
+{
+    const auto load_plan_version = [&entry] {
+        if constexpr (THREADING_POLICY::is_thread_safe) {
+            return std::atomic_ref(entry.plan_version).load(std::memory_order_acquire);
+        }
+
+        else {
+            return entry.plan_version;
+        }
+    };
+
+    if (load_plan_version() == _subscription_version) [[likely]] {
+        return entry.dispatch_plan;
+    }
+
+    if constexpr (!THREADING_POLICY::is_thread_safe) {
+        // A handler changed subscriptions and is dispatching again, so the outer dispatch is
+        // still walking the plan. It is rebuilt by the next dispatch once that one returns.
+        if (_is_walking_plan(entry)) {
+            return entry.dispatch_plan;
+        }
+    }
+
+    // A multi threaded dispatcher's subscriptions cannot change while any dispatch holds its
+    // lock, so only concurrent rebuilds are excluded
+    const std::unique_lock plan_lock { entry.plan_mutex };
+
+    if (entry.plan_version == _subscription_version) {
+        return entry.dispatch_plan;
+    }
+
+    entry.dispatch_plan.clear();
+
+    for (const auto& subscription : entry.subscriber_list) {
+        const auto& state = subscription.state;
+
+        const bool is_handler_call_only = state == nullptr
+                                          || (state->gate == nullptr
+                                              && state->strand == nullptr
+                                              && state->latency_budget == std::chrono::nanoseconds::zero());
+
+        entry.dispatch_plan.push_back({ subscription.subscriber, subscription.handler, is_handler_call_only ? nullptr : state.get() });
+    }
+
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        std::atomic_ref(entry.plan_version).store(_subscription_version, std::memory_order_release);
+    }
+
+    else {
+        entry.plan_version = _subscription_version;
+    }
+
+    return entry.dispatch_plan;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_dispatch_to_plan(const _EventTypeEntry_& entry, const EVENT_TYPE& event) const
+{
+    const auto& dispatch_plan = _get_dispatch_plan(entry);
+    const _PlanWalkScope_ plan_walk_scope { entry };
+
+    for (const auto& planned_handler : dispatch_plan) {
+        if (planned_handler.is_unsubscribed) [[unlikely]] {
+            continue;
+        }
+
+        if (planned_handler.state != nullptr) {
+            _handle_event(planned_handler, event);
+            continue;
+        }
+
+        const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, planned_handler.subscriber };
+        planned_handler.handler.function(planned_handler.handler.context, &event);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_is_walking_plan(const _EventTypeEntry_& entry)
+{
+    // A multi threaded dispatcher's handlers must not change subscriptions, so it never counts
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        return false;
+    }
+
+    else {
+        return entry.dispatch_depth != 0;
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_handle_event(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const
+{
+    const auto& gate = planned_handler.state->gate;
+
+    if (gate != nullptr && !_pass_delivery_gate(*gate, event)) [[unlikely]] {
+        return;
+    }
+
+    _deliver_event(planned_handler, event);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_deliver_event(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const
+{
+    if constexpr (std::is_copy_constructible_v<EVENT_TYPE>) {
+        if (planned_handler.state->strand != nullptr) {
+            _post_to_strand(planned_handler, event);
+            return;
+        }
+    }
+
+    const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, planned_handler.subscriber };
+
+    if (planned_handler.state->latency_budget == std::chrono::nanoseconds::zero()) {
+        planned_handler.handler.function(planned_handler.handler.context, &event);
+    }
+
+    else {
+        _handle_event_within_budget(planned_handler, event);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_parent(const BasicEventDispatcher* parent)
+{
+    for (auto ancestor = parent; ancestor != nullptr; ) {
+        if (ancestor == this) {
+            return false;
+        }
+
+        const std::shared_lock ancestor_lock { ancestor->_mutex };
+        ancestor = ancestor->_parent;
+    }
+
+    const std::unique_lock lock { _mutex };
+    _parent = parent;
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_recorder(EventRecorder* recorder)
+{
+    const std::unique_lock lock { _mutex };
+    _recorder = recorder;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::add_tap(EventTap* tap)
+{
+    const std::unique_lock lock { _mutex };
+
+    if (std::find(_tap_list.begin(), _tap_list.end(), tap) == _tap_list.end()) {
+        _tap_list.push_back(tap);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::remove_tap(EventTap* tap)
+{
+    const std::unique_lock lock { _mutex };
+    std::erase(_tap_list, tap);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_watchdog(LatencyWatchdog* watchdog)
+{
+    const std::unique_lock lock { _mutex };
+    _watchdog = watchdog;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_latency_budget(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber, std::chrono::nanoseconds latency_budget)
+{
+    const std::unique_lock lock { _mutex };
+    const auto subscription = _find_subscription<EVENT_TYPE>(subscriber);
+
+    if (subscription == nullptr) {
+        return false;
+    }
+
+    _get_or_create_state(*subscription).latency_budget = latency_budget;
+    ++_subscription_version;
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class SINGLE_EVENT_SUBSCRIBER_TYPE> requires _is_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_delivery_gate(SINGLE_EVENT_SUBSCRIBER_TYPE* subscriber, DeliveryGate delivery_gate)
+{
+    if (delivery_gate.count == 0 || (delivery_gate.mode == DeliveryMode::RATE_LIMITED && delivery_gate.interval <= std::chrono::nanoseconds::zero())) {
+        return false;
+    }
+
+    if (delivery_gate.mode == DeliveryMode::DEBOUNCED && !std::is_copy_constructible_v<EVENT_TYPE>) {
+        return false;
+    }
+
+    const std::unique_lock lock { _mutex };
+    const auto subscription = _find_subscription<EVENT_TYPE>(subscriber);
+
+    if (subscription == nullptr) {
+        return false;
+    }
+
+    if (delivery_gate.mode == DeliveryMode::EVERY_EVENT) {
+        if (subscription->state != nullptr) {
+            subscription->state->gate.reset();
+            ++_subscription_version;
+        }
+
+        return true;
+    }
+
+    auto gate_state = std::make_unique<_DeliveryGateState_>();
+    gate_state->gate = delivery_gate;
+    gate_state->token_count = delivery_gate.count;
+    gate_state->last_time = std::chrono::steady_clock::now();
+
+    if constexpr (std::is_copy_constructible_v<EVENT_TYPE>) {
+        if (delivery_gate.mode == DeliveryMode::DEBOUNCED) {
+            gate_state->latest_event = std::make_unique<_StickyEvent_<EVENT_TYPE>>();
+        }
+    }
+
+    _get_or_create_state(*subscription).gate = std::move(gate_state);
+    ++_subscription_version;
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline std::size_t BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::flush_debounced(std::chrono::steady_clock::time_point now) const
+{
+    std::size_t handled_count = 0;
+
+    const std::shared_lock lock { _mutex };
+
+    for (const auto& [type_id, entry] : _subscriber_map) {
+        // Walked like a dispatch, as the handlers called may change subscriptions
+        const auto& dispatch_plan = _get_dispatch_plan(entry);
+        const _PlanWalkScope_ plan_walk_scope { entry };
+
+        for (const auto& planned_handler : dispatch_plan) {
+            if (planned_handler.is_unsubscribed || planned_handler.state == nullptr) {
+                continue;
+            }
+
+            const auto& gate = planned_handler.state->gate;
+
+            if (gate == nullptr || gate->latest_event == nullptr) {
+                continue;
+            }
+
+            if (gate->latest_event->release(*this, planned_handler, now)) {
+                ++handled_count;
+            }
+        }
+    }
+
+    return handled_count;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE> requires std::derived_from<SUBSCRIBER_TYPE, _EventSubscriberBase_> || _is_static_event_subscriber_<SUBSCRIBER_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::set_strand(SUBSCRIBER_TYPE* subscriber, Strand* strand)
+{
+    const auto subscriber_key = _get_subscriber_key(subscriber);
+
+    bool subscription_found = false;
+
+    const std::unique_lock lock { _mutex };
+
+    for (auto& [type_id, entry] : _subscriber_map) {
+        for (auto& subscription : entry.subscriber_list) {
+            if (subscription.subscriber != subscriber_key) {
+                continue;
+            }
+
+            if (strand != nullptr || subscription.state != nullptr) {
+                _get_or_create_state(subscription).strand = strand;
+                ++_subscription_version;
+            }
+
+            subscription_found = true;
+        }
+    }
+
+    return subscription_found;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_pass_delivery_gate(_DeliveryGateState_& gate_state, const EVENT_TYPE& event)
+{
+    const std::unique_lock lock { gate_state.mutex };
+    const auto& gate = gate_state.gate;
+
+    switch (gate.mode) {
+        case DeliveryMode::EVERY_EVENT:
+            return true;
+
+        case DeliveryMode::EVERY_NTH:
+            return gate_state.event_count++ % gate.count == 0;
+
+        case DeliveryMode::RATE_LIMITED: {
+            const auto now = std::chrono::steady_clock::now();
+            const auto refill_count = (now - gate_state.last_time) / gate.interval;
+
+            if (refill_count >= gate.count - gate_state.token_count) {
+                gate_state.token_count = gate.count;
+                gate_state.last_time = now;
+            }
+
+            else {
+                gate_state.token_count += static_cast<std::uint32_t>(refill_count);
+                gate_state.last_time += refill_count * gate.interval;
+            }
+
+            if (gate_state.token_count == 0) {
+                return false;
+            }
+
+            --gate_state.token_count;
+            return true;
+        }
+
+        case DeliveryMode::DEBOUNCED:
+            // Kept in place of the previous event, and handled by `flush_debounced`
+            if constexpr (std::is_copy_constructible_v<EVENT_TYPE>) {
+                static_cast<_StickyEvent_<EVENT_TYPE>*>(gate_state.latest_event.get())->store(event);
+            }
+
+            gate_state.last_time = std::chrono::steady_clock::now();
+            return false;
+    }
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_is_quiet_period_over(_DeliveryGateState_& gate_state, std::chrono::steady_clock::time_point now)
+{
+    // `gate_state.mutex` is held by the caller
+    return now - gate_state.last_time >= gate_state.gate.interval;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_post_to_strand(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event)
+{
+    planned_handler.state->strand->_post(planned_handler.subscriber, type_id_v<EVENT_TYPE>, [subscriber = planned_handler.subscriber, handler = planned_handler.handler, event] {
+        const _InstrumentationScope_ handler_trace_scope { "handle_event", type_name_v<EVENT_TYPE>, subscriber };
+        handler.function(handler.context, &event);
+    });
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_handle_event_within_budget(const _PlannedHandler_& planned_handler, const EVENT_TYPE& event) const
+{
+    const auto handler = planned_handler.handler;
+    const auto& state = *planned_handler.state;
+
+    if constexpr (std::is_copy_constructible_v<EVENT_TYPE>) {
+        if (_is_demoted(state) && _watchdog != nullptr) {
+            _watchdog->_post_demoted(planned_handler.subscriber, type_id_v<EVENT_TYPE>, [handler, event] {
+                handler.function(handler.context, &event);
+            });
+
+            return;
+        }
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    handler.function(handler.context, &event);
+    const auto latency = std::chrono::steady_clock::now() - begin;
+
+    if (latency <= state.latency_budget) {
+        return;
+    }
+
+    const auto violation_count = _count_violation(state);
+
+    if (_watchdog == nullptr) {
+        return;
+    }
+
+    const auto demotion_threshold = _watchdog->get_demotion_threshold();
+
+    const bool demote = std::is_copy_constructible_v<EVENT_TYPE>
+                        && demotion_threshold != 0
+                        && violation_count >= demotion_threshold
+                        && _demote(state);
+
+    _watchdog->_report({
+        .subscriber = planned_handler.subscriber,
+        .event_type_name = type_name_v<EVENT_TYPE>,
+        .latency = std::chrono::duration_cast<std::chrono::nanoseconds>(latency),
+        .budget = state.latency_budget,
+        .violation_count = violation_count,
+        .demoted = demote,
+    });
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_is_demoted(const _SubscriptionState_& state)
+{
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        return std::atomic_ref(state.demoted).load(std::memory_order_relaxed);
+    }
+
+    else {
+        return state.demoted;
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_demote(const _SubscriptionState_& state)
+{
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        return !std::atomic_ref(state.demoted).exchange(true, std::memory_order_relaxed);
+    }
+
+    else {
+        return !std::exchange(state.demoted, true);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline std::uint32_t BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_count_violation(const _SubscriptionState_& state)
+{
+    if constexpr (THREADING_POLICY::is_thread_safe) {
+        return std::atomic_ref(state.violation_count).fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    else {
+        return ++state.violation_count;
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_or_create_state(_EventSubscription_& subscription) -> _SubscriptionState_&
+{
+    if (subscription.state == nullptr) {
+        subscription.state = std::make_unique<_SubscriptionState_>();
+    }
+
+    return *subscription.state;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE>
+inline const void* BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_subscriber_key(SUBSCRIBER_TYPE* subscriber)
+{
+    if constexpr (std::is_base_of_v<_EventSubscriberBase_, SUBSCRIBER_TYPE>) {
+        return static_cast<_EventSubscriberBase_*>(subscriber);
+    }
+
+    else {
+        return static_cast<_static_event_subscriber_base_t_<SUBSCRIBER_TYPE>*>(subscriber);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class SUBSCRIBER_TYPE>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_find_subscription(SUBSCRIBER_TYPE* subscriber) -> _EventSubscription_*
+{
+    auto event_subscribers_iter = _subscriber_map.find(type_id_v<EVENT_TYPE>);
+
+    if (event_subscribers_iter == _subscriber_map.end()) {
+        return nullptr;
+    }
+
+    auto& subscriber_list = event_subscribers_iter->second.subscriber_list;
+
+    const auto subscriber_key = _get_subscriber_key(subscriber);
+
+    const auto subscription_iter = std::find_if(subscriber_list.begin(), subscriber_list.end(), [subscriber_key](const _EventSubscription_& subscription) {
+        return subscription.subscriber == subscriber_key;
+    });
+
+    if (subscription_iter == subscriber_list.end()) {
+        return nullptr;
+    }
+
+    return &*subscription_iter;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class EVENT_TYPE, class SUBSCRIBER_TYPE>
+inline _EventHandler_ BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_event_handler(SUBSCRIBER_TYPE* subscriber)
+{
+    if constexpr (_is_virtual_subscriber_for_event_type_<SUBSCRIBER_TYPE, EVENT_TYPE>) {
+        return static_cast<_SingleEventSubscriber_<EVENT_TYPE>*>(subscriber)->_get_single_event_handler();
+    }
+
+    else {
+        using StaticSubscriberType = _static_event_subscriber_base_t_<SUBSCRIBER_TYPE>;
+        return { static_cast<StaticSubscriberType*>(subscriber), &StaticSubscriberType::template _handle_event<EVENT_TYPE> };
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE>
+inline std::span<const TypeId> BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_type_id_list(SUBSCRIBER_TYPE* subscriber)
+{
+    if constexpr (std::is_base_of_v<_EventSubscriberBase_, SUBSCRIBER_TYPE>) {
+        return static_cast<_EventSubscriberBase_*>(subscriber)->_get_event_type_id_list();
+    }
+
+    else {
+        return _static_event_subscriber_base_t_<SUBSCRIBER_TYPE>::_event_type_id_list;
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE>
+inline _EventHandler_ BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_type_handler(SUBSCRIBER_TYPE* subscriber, std::size_t type_index)
+{
+    if constexpr (std::is_base_of_v<_EventSubscriberBase_, SUBSCRIBER_TYPE>) {
+        return static_cast<_EventSubscriberBase_*>(subscriber)->_get_event_handler(type_index);
+    }
+
+    else {
+        return static_cast<_static_event_subscriber_base_t_<SUBSCRIBER_TYPE>*>(subscriber)->_get_event_handler(type_index);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_find_or_create_entry(TypeId type_id) -> _EventTypeEntry_*
+{
+    auto event_subscribers_iter = _subscriber_map.find(type_id);
+
+    if (event_subscribers_iter != _subscriber_map.end()) {
+        return &event_subscribers_iter->second;
+    }
+
+    if (_has_type_id_collision_(_subscriber_map, type_id)) {
+        return nullptr;
+    }
+
+    return &_subscriber_map[type_id];
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline auto BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_lock_and_find_or_create_entry(TypeId type_id) -> _EventTypeEntry_*
+{
+    const std::unique_lock lock { _mutex };
+    return _find_or_create_entry(type_id);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_subscribe_to_type_id(const void* subscriber, _EventHandler_ handler, TypeId type_id)
+{
+    const auto entry = _find_or_create_entry(type_id);
+
+    if (entry == nullptr) {
+        return false;
+    }
+
+    entry->subscriber_list.push_back({subscriber, handler});
+    ++_subscription_version;
+
+    return true;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_deliver_sticky_event(TypeId type_id, const _EventHandler_& handler) const
+{
+    const std::shared_lock lock { _mutex };
+    const auto event_subscribers_iter = _subscriber_map.find(type_id);
+
+    if (event_subscribers_iter != _subscriber_map.end() && event_subscribers_iter->second.sticky_event) {
+        event_subscribers_iter->second.sticky_event->deliver(handler);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_unsubscribe_from_type_id(const void* subscriber, TypeId type_id, std::vector<_UnboundStrand_>& unbound_strand_list)
+{
+    _unsubscribe_from_type_id_if(type_id, [subscriber](const void* subscription_subscriber) {
+        return subscription_subscriber == subscriber;
+    }, unbound_strand_list);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class PREDICATE_TYPE>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_unsubscribe_from_type_id_if(TypeId type_id, PREDICATE_TYPE is_unsubscribing, std::vector<_UnboundStrand_>& unbound_strand_list)
+{
+    auto event_subscribers_iter = _subscriber_map.find(type_id);
+
+    if (event_subscribers_iter == _subscriber_map.end()) {
+        return;
+    }
+
+    auto& entry = event_subscribers_iter->second;
+    const bool is_walking_plan = _is_walking_plan(entry);
+
+    for (auto& subscription : entry.subscriber_list) {
+        if (!is_unsubscribing(subscription.subscriber)) {
+            continue;
+        }
+
+        if (subscription.state != nullptr && subscription.state->strand != nullptr) {
+            subscription.state->strand->_forget(subscription.subscriber, type_id);
+            unbound_strand_list.push_back({ subscription.state->strand, subscription.subscriber, type_id });
+        }
+
+        // Only this event type's demoted deliveries are dropped, the subscriber may still handle others
+        if (_watchdog != nullptr) {
+            _watchdog->_forget(subscription.subscriber, type_id);
+        }
+
+        // The plan being walked, and the handler call running, may still refer to the state
+        if (is_walking_plan && subscription.state != nullptr) {
+            entry.retired_state_list.push_back(std::move(subscription.state));
+        }
+    }
+
+    std::erase_if(entry.subscriber_list, [&is_unsubscribing](const _EventSubscription_& subscription) {
+        return is_unsubscribing(subscription.subscriber);
+    });
+
+    // The rest of the walk skips the unsubscribed, which may be destroyed as soon as this returns
+    if (is_walking_plan) {
+        for (auto& planned_handler : entry.dispatch_plan) {
+            if (is_unsubscribing(planned_handler.subscriber)) {
+                planned_handler.is_unsubscribed = true;
+            }
+        }
+    }
+
+    ++_subscription_version;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicEventDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_wait_for_unbound_strands(const std::vector<_UnboundStrand_>& unbound_strand_list)
+{
+    // Called without the dispatcher's lock held, as a running handler call may be dispatching
+    for (const auto& unbound_strand : unbound_strand_list) {
+        unbound_strand.strand->_wait_until_not_running(unbound_strand.subscriber, unbound_strand.type_id);
     }
 }
 
@@ -0,0 +1,168 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#pragma once
+
+
+#include "shared/dispatchula_type_info.h"
+
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+namespace dispatch {
+
+
+/**
+ * Identifies a pipeline registered with `EventPipeline::to`, so that it can be removed with
+ * `EventDispatcher::remove_pipeline`. A default constructed handle identifies no pipeline.
+ */
+struct PipelineHandle {
+    const void* pipeline = nullptr;
+    TypeId input_type_id {};
+
+    explicit operator bool() const { return pipeline != nullptr; }
+};
+
+
+/**
+ * Clients should not use this class.
+ *
+ * The first stage of every pipeline, which passes the input event straight to the next stage.
+ */
+struct _IdentityPipelineStage_ {
+
+    template<class EVENT_TYPE, class SINK_TYPE>
+    void operator()(const EVENT_TYPE& event, SINK_TYPE&& sink) const { sink(event); }
+};
+
+
+/**
+ * Builds a pipeline from INPUT_EVENT_TYPE to another event type, one stage at a time. Start
+ * one with `EventDispatcher::on`.
+ *
+ * Each stage is a template parameter rather than a type erased function, and passes its
+ * output to the next stage as a direct call, so the compiler sees the whole pipeline as a
+ * single callable and can inline every stage into it. `to` registers that callable as a
+ * single subscription to INPUT_EVENT_TYPE, which looks up the output type's subscribers once
+ * at registration instead of on every dispatch.
+ *
+ * Builders are single use; every member function consumes the builder it is called on.
+ *
+ * Refer to the "Pipelines" section of `README.md` for example usage.
+ */
+template<class EVENT_DISPATCHER_TYPE, class INPUT_EVENT_TYPE, class OUTPUT_TYPE, class STAGE_TYPE>
+class EventPipeline {
+
+public:
+
+    EventPipeline(EVENT_DISPATCHER_TYPE& event_dispatcher, STAGE_TYPE stage);
+
+    /**
+     * Adds a stage that only passes on values for which `predicate` returns true.
+     */
+    template<class PREDICATE_TYPE> requires std::predicate<PREDICATE_TYPE&, const OUTPUT_TYPE&>
+    auto filter(PREDICATE_TYPE predicate) &&;
+
+    /**
+     * Adds a stage that passes on the result of calling `function` with each value.
+     */
+    template<class FUNCTION_TYPE> requires std::invocable<FUNCTION_TYPE&, const OUTPUT_TYPE&>
+    auto map(FUNCTION_TYPE function) &&;
+
+    /**
+     * Registers the pipeline with the dispatcher, which then dispatches every value that
+     * reaches the end of the pipeline as an EVENT_TYPE. Returns an empty handle only if
+     * either event type's TypeId hash collides with another event type's.
+     */
+    template<class EVENT_TYPE> requires std::constructible_from<EVENT_TYPE, const OUTPUT_TYPE&>
+    PipelineHandle to() &&;
+
+private:
+
+    EVENT_DISPATCHER_TYPE& _event_dispatcher;
+    STAGE_TYPE _stage;
+};
+
+
+template<class EVENT_DISPATCHER_TYPE, class INPUT_EVENT_TYPE, class OUTPUT_TYPE, class STAGE_TYPE>
+inline EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, OUTPUT_TYPE, STAGE_TYPE>::EventPipeline(EVENT_DISPATCHER_TYPE& event_dispatcher, STAGE_TYPE stage)
+    : _event_dispatcher(event_dispatcher)
+    , _stage(std::move(stage))
+{}
+
+template<class EVENT_DISPATCHER_TYPE, class INPUT_EVENT_TYPE, class OUTPUT_TYPE, class STAGE_TYPE>
+template<class PREDICATE_TYPE> requires std::predicate<PREDICATE_TYPE&, const OUTPUT_TYPE&>
+inline auto EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, OUTPUT_TYPE, STAGE_TYPE>::filter(PREDICATE_TYPE predicate) &&
+{
+    auto stage = [previous_stage = std::move(_stage), predicate = std::move(predicate)](const INPUT_EVENT_TYPE& event, auto&& sink) mutable {
+        previous_stage(event, [&predicate, &sink](const OUTPUT_TYPE& value) {
+            if (std::invoke(predicate, value)) {
+                sink(value);
+            }
+        });
+    };
+
+    return EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, OUTPUT_TYPE, decltype(stage)>(_event_dispatcher, std::move(stage));
+}
+
+template<class EVENT_DISPATCHER_TYPE, class INPUT_EVENT_TYPE, class OUTPUT_TYPE, class STAGE_TYPE>
+template<class FUNCTION_TYPE> requires std::invocable<FUNCTION_TYPE&, const OUTPUT_TYPE&>
+inline auto EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, OUTPUT_TYPE, STAGE_TYPE>::map(FUNCTION_TYPE function) &&
+{
+    using MappedType = std::decay_t<std::invoke_result_t<FUNCTION_TYPE&, const OUTPUT_TYPE&>>;
+
+    auto stage = [previous_stage = std::move(_stage), function = std::move(function)](const INPUT_EVENT_TYPE& event, auto&& sink) mutable {
+        previous_stage(event, [&function, &sink](const OUTPUT_TYPE& value) {
+            sink(std::invoke(function, value));
+        });
+    };
+
+    return EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, MappedType, decltype(stage)>(_event_dispatcher, std::move(stage));
+}
+
+template<class EVENT_DISPATCHER_TYPE, class INPUT_EVENT_TYPE, class OUTPUT_TYPE, class STAGE_TYPE>
+template<class EVENT_TYPE> requires std::constructible_from<EVENT_TYPE, const OUTPUT_TYPE&>
+inline PipelineHandle EventPipeline<EVENT_DISPATCHER_TYPE, INPUT_EVENT_TYPE, OUTPUT_TYPE, STAGE_TYPE>::to() &&
+{
+    const auto output_entry = _event_dispatcher._lock_and_find_or_create_entry(type_id_v<EVENT_TYPE>);
+
+    if (output_entry == nullptr) {
+        return {};
+    }
+
+    auto& event_dispatcher = _event_dispatcher;
+
+    return event_dispatcher.template _add_pipeline<INPUT_EVENT_TYPE>([stage = std::move(_stage), &event_dispatcher, output_entry](const INPUT_EVENT_TYPE& event) mutable {
+        stage(event, [&event_dispatcher, output_entry](const OUTPUT_TYPE& value) {
+            if constexpr (std::same_as<OUTPUT_TYPE, EVENT_TYPE>) {
+                event_dispatcher._dispatch_to_entry(output_entry, value);
+            }
+
+            else {
+                event_dispatcher._dispatch_to_entry(output_entry, EVENT_TYPE(value));
+            }
+        });
+    });
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,119 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "async/bounded_queue.h"
+#include "event_dispatcher.h"
+
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+
+namespace dispatch {
+
+
+/**
+ * A bounded, thread safe queue of events of a single type, for producers on any thread to
+ * hand events to the thread that owns an event dispatcher.
+ *
+ * `post` queues a copy of an event, and `dispatch_queued` dispatches queued events, oldest
+ * first. At most `capacity` events are queued, and `overflow_policy` decides what happens
+ * to events posted while the queue is full.
+ *
+ * Refer to the "Event Queue" section of `README.md` for example usage.
+ */
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+class EventQueue {
+
+public:
+
+    EventQueue(std::size_t capacity, OverflowPolicy overflow_policy);
+
+    /**
+     * Returns false only if `event` was dropped because the queue is full.
+     */
+    bool post(EVENT_TYPE event);
+
+    /**
+     * Dispatches up to `max_event_count` queued events with `event_dispatcher`, a
+     * BasicEventDispatcher of any configuration, returning how many were dispatched.
+     */
+    template<class EVENT_DISPATCHER_TYPE>
+    std::size_t dispatch_queued(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count = std::numeric_limits<std::size_t>::max());
+
+    std::size_t get_depth() const;
+    QueueMetrics get_metrics() const;
+
+private:
+
+    BoundedQueue<EVENT_TYPE> _event_queue;
+};
+
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline EventQueue<EVENT_TYPE>::EventQueue(std::size_t capacity, OverflowPolicy overflow_policy)
+    : _event_queue(capacity, overflow_policy)
+{
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline bool EventQueue<EVENT_TYPE>::post(EVENT_TYPE event)
+{
+    return _event_queue.push(std::move(event));
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t EventQueue<EVENT_TYPE>::dispatch_queued(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count)
+{
+    std::size_t dispatched_count = 0;
+
+    while (dispatched_count < max_event_count) {
+        const auto event = _event_queue.try_pop();
+
+        if (!event.has_value()) {
+            break;
+        }
+
+        event_dispatcher.dispatch(*event);
+        ++dispatched_count;
+    }
+
+    return dispatched_count;
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline std::size_t EventQueue<EVENT_TYPE>::get_depth() const
+{
+    return _event_queue.get_depth();
+}
+
+template<class EVENT_TYPE> requires std::move_constructible<EVENT_TYPE>
+inline QueueMetrics EventQueue<EVENT_TYPE>::get_metrics() const
+{
+    return _event_queue.get_metrics();
+}
+
+
+} // namespace dispatch
@@ -22,9 +22,13 @@
 
 
 #include "shared/dispatchula_concepts.h"
+#include "shared/dispatchula_type_info.h"
 
-#include <typeindex>
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 
 namespace dispatch {
@@ -43,6 +47,24 @@ namespace dispatch {
 template<class ... EVENT_TYPE_LIST> requires _are_unique_types_<EVENT_TYPE_LIST...>
 class EventSubscriber;
 
+/**
+ * An alternative to EventSubscriber for classes that do not need to handle events through
+ * a virtual function call.
+ *
+ * The derived class implements one non-virtual `handle_event` function per event type, which
+ * the EventDispatcher calls directly. The derived class has no vtable pointers or virtual base
+ * classes, and its handlers can be inlined into the dispatcher's call to them. Handler functions
+ * must be public, or the derived class must befriend this class.
+ *
+ * Clients should use this class only to derive from when subscribing to events.
+ *
+ * @tparam DERIVED_TYPE    - is the derived subscribing class itself
+ * @tparam EVENT_TYPE_LIST - is a list of all event types the derived subscribing class
+ *                           will ever wish to subscribe to.
+ */
+template<class DERIVED_TYPE, class ... EVENT_TYPE_LIST> requires _are_unique_types_<EVENT_TYPE_LIST...>
+class StaticEventSubscriber;
+
 /**
  * A base class used only by the EventDispatcher to allow subscribing and unsubscribing
  * to all events that a subscribing class is subscribed to.
@@ -62,40 +84,120 @@ class _EventSubscriberBase_;
 template<class EVENT_TYPE>
 class _SingleEventSubscriber_;
 
+/**
+ * A type erased handler function for a single event type, and the subscriber it is called on.
+ *
+ * Clients should not use this struct.
+ */
+struct _EventHandler_ {
+    void* context;
+    void (*function)(void* context, const void* event);
+};
+
 
-class EventDispatcher;
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicEventDispatcher;
 
 
 class _EventSubscriberBase_
 {
-    friend EventDispatcher;
+    template<class, class, class>
+    friend class BasicEventDispatcher;
+
+    virtual std::span<const TypeId> _get_event_type_id_list() = 0;
 
-    virtual const std::vector<std::type_index>& _get_event_type_id_list() = 0;
+    /**
+     * Returns the handler for the event type at `type_index` in `_get_event_type_id_list()`.
+     */
+    virtual _EventHandler_ _get_event_handler(std::size_t type_index) = 0;
 };
 
 
 template<class EVENT_TYPE>
 class _SingleEventSubscriber_ : virtual public _EventSubscriberBase_
 {
-    friend EventDispatcher;
+    template<class, class, class>
+    friend class BasicEventDispatcher;
 
     virtual void handle_event(const EVENT_TYPE& dispatch) = 0;
+
+    static void _handle_event(void* context, const void* event) {
+        static_cast<_SingleEventSubscriber_*>(context)->handle_event(*static_cast<const EVENT_TYPE*>(event));
+    }
+
+protected:
+
+    _EventHandler_ _get_single_event_handler() {
+        return { this, &_handle_event };
+    }
 };
 
 
 template<class ... EVENT_TYPE_LIST> requires _are_unique_types_<EVENT_TYPE_LIST...>
 class EventSubscriber : public _SingleEventSubscriber_<EVENT_TYPE_LIST>...
 {
-    const std::vector<std::type_index>& _get_event_type_id_list() override {
+    std::span<const TypeId> _get_event_type_id_list() override {
         return _event_type_id_list;
     }
 
-    static inline const std::vector<std::type_index> _event_type_id_list = { typeid(EVENT_TYPE_LIST)... };
+    _EventHandler_ _get_event_handler(std::size_t type_index) override {
+        const _EventHandler_ event_handler_list[] = { _SingleEventSubscriber_<EVENT_TYPE_LIST>::_get_single_event_handler()... };
+        return event_handler_list[type_index];
+    }
+
+    static constexpr std::array<TypeId, sizeof...(EVENT_TYPE_LIST)> _event_type_id_list = { type_id_v<EVENT_TYPE_LIST>... };
 };
 
 
+template<class DERIVED_TYPE, class ... EVENT_TYPE_LIST> requires _are_unique_types_<EVENT_TYPE_LIST...>
+class StaticEventSubscriber
+{
+    template<class, class, class>
+    friend class BasicEventDispatcher;
+
+    template<class EVENT_TYPE>
+    static void _handle_event(void* context, const void* event) {
+        static_cast<DERIVED_TYPE*>(context)->handle_event(*static_cast<const EVENT_TYPE*>(event));
+    }
+
+    _EventHandler_ _get_event_handler(std::size_t type_index) {
+        const _EventHandler_ event_handler_list[] = { { static_cast<DERIVED_TYPE*>(this), &_handle_event<EVENT_TYPE_LIST> }... };
+        return event_handler_list[type_index];
+    }
+
+    static constexpr std::array<TypeId, sizeof...(EVENT_TYPE_LIST)> _event_type_id_list = { type_id_v<EVENT_TYPE_LIST>... };
+};
+
+
+/**
+ * Only declared, to deduce the StaticEventSubscriber base class of a subscriber type.
+ */
+template<class DERIVED_TYPE, class ... EVENT_TYPE_LIST>
+StaticEventSubscriber<DERIVED_TYPE, EVENT_TYPE_LIST...>* _as_static_event_subscriber_(StaticEventSubscriber<DERIVED_TYPE, EVENT_TYPE_LIST...>* subscriber);
+
+template<class EVENT_TYPE, class DERIVED_TYPE, class ... EVENT_TYPE_LIST>
+constexpr bool _static_event_subscriber_handles_(StaticEventSubscriber<DERIVED_TYPE, EVENT_TYPE_LIST...>*)
+{
+    return (std::is_same_v<EVENT_TYPE, EVENT_TYPE_LIST> || ...);
+}
+
+
+template<class SUBSCRIBER_TYPE>
+concept _is_static_event_subscriber_ = requires(SUBSCRIBER_TYPE* subscriber) { _as_static_event_subscriber_(subscriber); };
+
+template<class SUBSCRIBER_TYPE>
+using _static_event_subscriber_base_t_ = std::remove_pointer_t<decltype(_as_static_event_subscriber_(std::declval<SUBSCRIBER_TYPE*>()))>;
+
+template<class SINGLE_EVENT_SUBSCRIBER_TYPE, class EVENT_TYPE>
+concept _is_virtual_subscriber_for_event_type_ = std::is_base_of_v<_SingleEventSubscriber_<EVENT_TYPE>, SINGLE_EVENT_SUBSCRIBER_TYPE>;
+
+template<class SINGLE_EVENT_SUBSCRIBER_TYPE, class EVENT_TYPE>
+concept _is_static_subscriber_for_event_type_ = _is_static_event_subscriber_<SINGLE_EVENT_SUBSCRIBER_TYPE>
+                                                && _static_event_subscriber_handles_<EVENT_TYPE>(static_cast<SINGLE_EVENT_SUBSCRIBER_TYPE*>(nullptr));
+
 template<class SINGLE_EVENT_SUBSCRIBER_TYPE, class EVENT_TYPE>
-concept _is_subscriber_for_event_type_ = std::is_base_of_v<_SingleEventSubscriber_<EVENT_TYPE>, SINGLE_EVENT_SUBSCRIBER_TYPE>;
+concept _is_subscriber_for_event_type_ = _is_virtual_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>
+                                         || _is_static_subscriber_for_event_type_<SINGLE_EVENT_SUBSCRIBER_TYPE, EVENT_TYPE>;
 
 
 } // namespace dispatch
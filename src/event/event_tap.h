@@ -0,0 +1,186 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#pragma once
+
+
+#include "shared/dispatchula_type_info.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * An event seen by an EventTap.
+ *
+ * `event` points to the dispatched event, which is only valid during `tap_event`.
+ * `event_bytes` holds the event's bytes if it is trivially copyable, and is empty otherwise.
+ */
+struct TappedEvent {
+    TypeId type_id;
+    std::string_view type_name;
+    const void* event;
+    std::span<const std::byte> event_bytes;
+};
+
+
+/**
+ * Observes every event dispatched by each EventDispatcher it is added to with
+ * `EventDispatcher::add_tap`, whatever its type, before the event is handled.
+ *
+ * `tap_event` is called on the dispatching thread.
+ */
+class EventTap {
+
+public:
+
+    virtual ~EventTap() = default;
+
+    virtual void tap_event(const TappedEvent& tapped_event) = 0;
+};
+
+
+/**
+ * An EventTap that copies each tapped event into a fixed size ring buffer, so that events can
+ * be inspected in batches, on another thread, without slowing down dispatch.
+ *
+ * Each slot holds up to `max_event_size` bytes of event. Larger events, and events that are
+ * not trivially copyable, are buffered with their type only. When the buffer is full, the
+ * oldest buffered event is overwritten and counted by `get_dropped_count`.
+ */
+class EventTapBuffer : public EventTap {
+
+public:
+
+    EventTapBuffer(std::size_t capacity, std::size_t max_event_size);
+
+    void tap_event(const TappedEvent& tapped_event) override;
+
+    /**
+     * Calls `handler` with each buffered event, oldest first, and removes them from the buffer.
+     * The `event` of each TappedEvent passed to `handler` is nullptr. Returns the number of
+     * events handled.
+     */
+    template<class HANDLER_TYPE> requires std::invocable<HANDLER_TYPE&, const TappedEvent&>
+    std::size_t drain(HANDLER_TYPE&& handler);
+
+    std::size_t get_buffered_count() const;
+    std::uint64_t get_dropped_count() const;
+
+private:
+
+    struct _BufferedEventHeader_ {
+        TypeId type_id;
+        std::size_t event_size;
+    };
+
+    std::size_t _capacity;
+    std::size_t _max_event_size;
+    std::vector<_BufferedEventHeader_> _header_list;
+    std::vector<std::byte> _event_byte_list;
+    std::uint64_t _read_count = 0;
+    std::uint64_t _write_count = 0;
+    std::uint64_t _dropped_count = 0;
+    mutable std::mutex _mutex {};
+};
+
+
+inline EventTapBuffer::EventTapBuffer(std::size_t capacity, std::size_t max_event_size)
+    : _capacity(std::max<std::size_t>(capacity, 1))
+    , _max_event_size(max_event_size)
+    , _header_list(_capacity)
+    , _event_byte_list(_capacity * max_event_size)
+{}
+
+inline void EventTapBuffer::tap_event(const TappedEvent& tapped_event)
+{
+    const std::lock_guard lock { _mutex };
+
+    if (_write_count - _read_count == _capacity) {
+        ++_read_count;
+        ++_dropped_count;
+    }
+
+    const auto slot_index = _write_count % _capacity;
+    const auto event_size = tapped_event.event_bytes.size() <= _max_event_size ? tapped_event.event_bytes.size() : 0;
+
+    _header_list[slot_index] = { tapped_event.type_id, event_size };
+
+    if (event_size != 0) {
+        std::memcpy(_event_byte_list.data() + slot_index * _max_event_size, tapped_event.event_bytes.data(), event_size);
+    }
+
+    ++_write_count;
+}
+
+template<class HANDLER_TYPE> requires std::invocable<HANDLER_TYPE&, const TappedEvent&>
+inline std::size_t EventTapBuffer::drain(HANDLER_TYPE&& handler)
+{
+    std::vector<std::byte> event_bytes(_max_event_size);
+    std::size_t handled_count = 0;
+
+    while (true) {
+        _BufferedEventHeader_ header;
+
+        {
+            const std::lock_guard lock { _mutex };
+
+            if (_read_count == _write_count) {
+                return handled_count;
+            }
+
+            const auto slot_index = _read_count % _capacity;
+            header = _header_list[slot_index];
+
+            if (header.event_size != 0) {
+                std::memcpy(event_bytes.data(), _event_byte_list.data() + slot_index * _max_event_size, header.event_size);
+            }
+
+            ++_read_count;
+        }
+
+        handler(TappedEvent { header.type_id, header.type_id.name, nullptr, std::span { event_bytes.data(), header.event_size } });
+        ++handled_count;
+    }
+}
+
+inline std::size_t EventTapBuffer::get_buffered_count() const
+{
+    const std::lock_guard lock { _mutex };
+    return _write_count - _read_count;
+}
+
+inline std::uint64_t EventTapBuffer::get_dropped_count() const
+{
+    const std::lock_guard lock { _mutex };
+    return _dropped_count;
+}
+
+
+} // namespace dispatch
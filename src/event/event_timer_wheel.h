@@ -0,0 +1,435 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event_dispatcher.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * Identifies a timer scheduled on an EventTimerWheel, for cancelling it. A handle stays
+ * safe to cancel after its timer has fired or been cancelled, as timer slots are reused
+ * with a new generation.
+ */
+struct TimerHandle {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+};
+
+/**
+ * Dispatches events with an event dispatcher after a delay, or periodically.
+ * EVENT_DISPATCHER_TYPE is the BasicEventDispatcher configuration dispatched with, and is
+ * deduced from the constructor's argument.
+ *
+ * Timers are kept in a hierarchical timing wheel of LEVEL_COUNT levels of SLOT_COUNT slots,
+ * each slot a list of timers. Level 0 has a slot per tick, and each higher level has a slot
+ * per SLOT_COUNT slots of the level below, so scheduling and cancelling a timer take
+ * constant time however many are pending. Timers far enough ahead to need a higher level
+ * are moved down a level each time the level below wraps around.
+ *
+ * The wheel only moves when `advance` is called, typically from the same loop that calls
+ * `EventQueue::dispatch_queued`, and every event due within the elapsed ticks is dispatched
+ * from within `advance`. Event handlers may schedule and cancel timers, but the wheel is
+ * not thread safe.
+ *
+ * Refer to the "Event Timer Wheel" section of `README.md` for example usage.
+ */
+template<class EVENT_DISPATCHER_TYPE = EventDispatcher>
+class EventTimerWheel {
+
+public:
+
+    static constexpr std::size_t SLOT_BIT_COUNT = 8;
+    static constexpr std::size_t SLOT_COUNT = std::size_t { 1 } << SLOT_BIT_COUNT;
+    static constexpr std::size_t LEVEL_COUNT = 4;
+
+    explicit EventTimerWheel(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::chrono::nanoseconds tick_duration = std::chrono::milliseconds(1));
+
+    /**
+     * Dispatches `event` once `delay` has elapsed, rounded up to a whole number of ticks
+     * (and at least one tick).
+     */
+    template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+    TimerHandle dispatch_after(std::chrono::nanoseconds delay, EVENT_TYPE event);
+
+    /**
+     * Dispatches `event` every `period`, rounded up to a whole number of ticks (and at least
+     * one tick), until cancelled.
+     */
+    template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+    TimerHandle dispatch_every(std::chrono::nanoseconds period, EVENT_TYPE event);
+
+    /**
+     * Returns false if the timer has already fired (and is not periodic) or been cancelled.
+     * A periodic timer may cancel itself from within the handler of its own event.
+     */
+    bool cancel(TimerHandle timer_handle);
+
+    /**
+     * Moves the wheel on by `elapsed`, dispatching every event that falls due, in the order
+     * they fall due. Returns how many events were dispatched. Time left over from partial
+     * ticks is carried into the next call.
+     */
+    std::size_t advance(std::chrono::nanoseconds elapsed);
+
+    std::size_t get_pending_count() const;
+    std::chrono::nanoseconds get_tick_duration() const;
+
+private:
+
+    static constexpr std::uint32_t _NO_TIMER_ = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t _FIRING_LIST_INDEX_ = LEVEL_COUNT * SLOT_COUNT;
+
+    enum class _TimerState_ : std::uint8_t {
+        FREE,
+        PENDING,
+        FIRING,
+    };
+
+    struct _Timer_ {
+        std::function<void(const EVENT_DISPATCHER_TYPE&)> dispatch {};
+        std::uint64_t expiry_tick = 0;
+        std::uint64_t period_tick_count = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t previous = _NO_TIMER_;
+        std::uint32_t next = _NO_TIMER_;
+        std::uint32_t list_index = 0;
+        _TimerState_ state = _TimerState_::FREE;
+    };
+
+    std::uint64_t _to_tick_count(std::chrono::nanoseconds duration) const;
+
+    TimerHandle _schedule(std::uint64_t delay_tick_count, std::uint64_t period_tick_count, std::function<void(const EVENT_DISPATCHER_TYPE&)> dispatch);
+    void _insert(std::uint32_t timer_index);
+    void _link(std::uint32_t timer_index, std::size_t list_index);
+    void _unlink(std::uint32_t timer_index);
+    void _free(std::uint32_t timer_index);
+    void _cascade(std::size_t level_index, std::uint64_t tick);
+    std::size_t _fire_tick();
+
+    const EVENT_DISPATCHER_TYPE& _event_dispatcher;
+    const std::chrono::nanoseconds _tick_duration;
+
+    std::uint64_t _current_tick = 0;
+    std::chrono::nanoseconds _partial_tick_time { 0 };
+
+    // A deque, so timers stay in place while their event is dispatched, even if a handler
+    // schedules enough new timers to grow the list
+    std::deque<_Timer_> _timer_list {};
+    std::vector<std::uint32_t> _free_timer_index_list {};
+    std::size_t _pending_count = 0;
+
+    std::array<std::uint32_t, _FIRING_LIST_INDEX_ + 1> _list_head_list {};
+};
+
+
+template<class EVENT_DISPATCHER_TYPE>
+inline EventTimerWheel<EVENT_DISPATCHER_TYPE>::EventTimerWheel(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::chrono::nanoseconds tick_duration)
+    : _event_dispatcher(event_dispatcher)
+    , _tick_duration(std::max(tick_duration, std::chrono::nanoseconds(1)))
+{
+    _list_head_list.fill(_NO_TIMER_);
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline TimerHandle EventTimerWheel<EVENT_DISPATCHER_TYPE>::dispatch_after(std::chrono::nanoseconds delay, EVENT_TYPE event)
+{
+    return _schedule(_to_tick_count(delay), 0, [event = std::move(event)](const EVENT_DISPATCHER_TYPE& event_dispatcher) {
+        event_dispatcher.dispatch(event);
+    });
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE> requires std::copy_constructible<EVENT_TYPE>
+inline TimerHandle EventTimerWheel<EVENT_DISPATCHER_TYPE>::dispatch_every(std::chrono::nanoseconds period, EVENT_TYPE event)
+{
+    const auto period_tick_count = _to_tick_count(period);
+
+    return _schedule(period_tick_count, period_tick_count, [event = std::move(event)](const EVENT_DISPATCHER_TYPE& event_dispatcher) {
+        event_dispatcher.dispatch(event);
+    });
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline bool EventTimerWheel<EVENT_DISPATCHER_TYPE>::cancel(TimerHandle timer_handle)
+{
+    if (timer_handle.index >= _timer_list.size()) {
+        return false;
+    }
+
+    auto& timer = _timer_list[timer_handle.index];
+
+    if (timer.generation != timer_handle.generation) {
+        return false;
+    }
+
+    switch (timer.state) {
+        case _TimerState_::FREE:
+            return false;
+
+        case _TimerState_::PENDING:
+            _unlink(timer_handle.index);
+            _free(timer_handle.index);
+            return true;
+
+        case _TimerState_::FIRING: {
+            // Freed by `_fire_tick` once its event has been dispatched
+            const bool was_periodic = timer.period_tick_count != 0;
+            timer.period_tick_count = 0;
+            return was_periodic;
+        }
+    }
+
+    return false;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t EventTimerWheel<EVENT_DISPATCHER_TYPE>::advance(std::chrono::nanoseconds elapsed)
+{
+    _partial_tick_time += elapsed;
+
+    auto tick_count = static_cast<std::uint64_t>(_partial_tick_time / _tick_duration);
+    _partial_tick_time %= _tick_duration;
+
+    std::size_t fired_count = 0;
+
+    for (; tick_count != 0; --tick_count) {
+        if (_pending_count == 0) {
+            _current_tick += tick_count;
+            break;
+        }
+
+        fired_count += _fire_tick();
+    }
+
+    return fired_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t EventTimerWheel<EVENT_DISPATCHER_TYPE>::get_pending_count() const
+{
+    return _pending_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::chrono::nanoseconds EventTimerWheel<EVENT_DISPATCHER_TYPE>::get_tick_duration() const
+{
+    return _tick_duration;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::uint64_t EventTimerWheel<EVENT_DISPATCHER_TYPE>::_to_tick_count(std::chrono::nanoseconds duration) const
+{
+    if (duration <= std::chrono::nanoseconds::zero()) {
+        return 1;
+    }
+
+    return static_cast<std::uint64_t>((duration + _tick_duration - std::chrono::nanoseconds(1)) / _tick_duration);
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline TimerHandle EventTimerWheel<EVENT_DISPATCHER_TYPE>::_schedule(std::uint64_t delay_tick_count, std::uint64_t period_tick_count, std::function<void(const EVENT_DISPATCHER_TYPE&)> dispatch)
+{
+    std::uint32_t timer_index;
+
+    if (_free_timer_index_list.empty()) {
+        timer_index = static_cast<std::uint32_t>(_timer_list.size());
+        _timer_list.emplace_back();
+    }
+
+    else {
+        timer_index = _free_timer_index_list.back();
+        _free_timer_index_list.pop_back();
+    }
+
+    auto& timer = _timer_list[timer_index];
+    timer.dispatch = std::move(dispatch);
+    timer.expiry_tick = _current_tick + delay_tick_count;
+    timer.period_tick_count = period_tick_count;
+
+    _insert(timer_index);
+    ++_pending_count;
+
+    return { timer_index, timer.generation };
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline void EventTimerWheel<EVENT_DISPATCHER_TYPE>::_insert(std::uint32_t timer_index)
+{
+    auto& timer = _timer_list[timer_index];
+    timer.state = _TimerState_::PENDING;
+
+    // Ticks after the next tick to fire, which is the first tick level 0 covers
+    const auto delta = timer.expiry_tick - (_current_tick + 1);
+
+    for (std::size_t level_index = 0; level_index < LEVEL_COUNT; ++level_index) {
+        const auto level_shift = level_index * SLOT_BIT_COUNT;
+
+        if (delta < (std::uint64_t { 1 } << (level_shift + SLOT_BIT_COUNT)) || level_index == LEVEL_COUNT - 1) {
+            // Timers beyond the top level's range wait in its furthest slot, and are
+            // reinserted from there when it cascades
+            const auto slot_tick = std::min(timer.expiry_tick, _current_tick + (std::uint64_t { 1 } << (level_shift + SLOT_BIT_COUNT)));
+            const auto slot_index = (slot_tick >> level_shift) & (SLOT_COUNT - 1);
+
+            _link(timer_index, level_index * SLOT_COUNT + slot_index);
+            return;
+        }
+    }
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline void EventTimerWheel<EVENT_DISPATCHER_TYPE>::_link(std::uint32_t timer_index, std::size_t list_index)
+{
+    auto& timer = _timer_list[timer_index];
+    auto& list_head = _list_head_list[list_index];
+
+    timer.list_index = static_cast<std::uint32_t>(list_index);
+    timer.previous = _NO_TIMER_;
+    timer.next = list_head;
+
+    if (list_head != _NO_TIMER_) {
+        _timer_list[list_head].previous = timer_index;
+    }
+
+    list_head = timer_index;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline void EventTimerWheel<EVENT_DISPATCHER_TYPE>::_unlink(std::uint32_t timer_index)
+{
+    auto& timer = _timer_list[timer_index];
+
+    if (timer.previous != _NO_TIMER_) {
+        _timer_list[timer.previous].next = timer.next;
+    }
+
+    else {
+        _list_head_list[timer.list_index] = timer.next;
+    }
+
+    if (timer.next != _NO_TIMER_) {
+        _timer_list[timer.next].previous = timer.previous;
+    }
+
+    timer.previous = _NO_TIMER_;
+    timer.next = _NO_TIMER_;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline void EventTimerWheel<EVENT_DISPATCHER_TYPE>::_free(std::uint32_t timer_index)
+{
+    auto& timer = _timer_list[timer_index];
+
+    timer.dispatch = nullptr;
+    timer.state = _TimerState_::FREE;
+    ++timer.generation;
+
+    _free_timer_index_list.push_back(timer_index);
+    --_pending_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline void EventTimerWheel<EVENT_DISPATCHER_TYPE>::_cascade(std::size_t level_index, std::uint64_t tick)
+{
+    const auto slot_index = (tick >> (level_index * SLOT_BIT_COUNT)) & (SLOT_COUNT - 1);
+    auto& list_head = _list_head_list[level_index * SLOT_COUNT + slot_index];
+
+    auto timer_index = list_head;
+    list_head = _NO_TIMER_;
+
+    while (timer_index != _NO_TIMER_) {
+        const auto next_timer_index = _timer_list[timer_index].next;
+        _insert(timer_index);
+        timer_index = next_timer_index;
+    }
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t EventTimerWheel<EVENT_DISPATCHER_TYPE>::_fire_tick()
+{
+    const auto tick = _current_tick + 1;
+
+    // Moves timers due within the next SLOT_COUNT ticks of each level down, from the highest
+    // level that has wrapped around to level 1, before firing level 0's slot for this tick
+    std::size_t cascade_level_count = 0;
+
+    while (cascade_level_count + 1 < LEVEL_COUNT
+           && (tick & ((std::uint64_t { 1 } << ((cascade_level_count + 1) * SLOT_BIT_COUNT)) - 1)) == 0) {
+        ++cascade_level_count;
+    }
+
+    for (std::size_t level_index = cascade_level_count; level_index > 0; --level_index) {
+        _cascade(level_index, tick);
+    }
+
+    // Timers scheduled by handlers below are measured from after this tick
+    _current_tick = tick;
+
+    auto& firing_list_head = _list_head_list[_FIRING_LIST_INDEX_];
+    const auto slot_list_index = tick & (SLOT_COUNT - 1);
+
+    firing_list_head = std::exchange(_list_head_list[slot_list_index], _NO_TIMER_);
+
+    for (auto timer_index = firing_list_head; timer_index != _NO_TIMER_; timer_index = _timer_list[timer_index].next) {
+        _timer_list[timer_index].list_index = _FIRING_LIST_INDEX_;
+    }
+
+    std::size_t fired_count = 0;
+
+    while (firing_list_head != _NO_TIMER_) {
+        const auto timer_index = firing_list_head;
+        auto& timer = _timer_list[timer_index];
+
+        _unlink(timer_index);
+        timer.state = _TimerState_::FIRING;
+
+        timer.dispatch(_event_dispatcher);
+        ++fired_count;
+
+        if (timer.period_tick_count == 0) {
+            _free(timer_index);
+        }
+
+        else {
+            timer.expiry_tick += timer.period_tick_count;
+            _insert(timer_index);
+        }
+    }
+
+    return fired_count;
+}
+
+
+} // namespace dispatch
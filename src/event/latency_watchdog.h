@@ -0,0 +1,184 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "async/bounded_queue.h"
+#include "shared/dispatchula_type_info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+
+namespace dispatch {
+
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicEventDispatcher;
+
+
+/**
+ * Describes a single handler call that took longer than its subscription's latency budget.
+ *
+ * `violation_count` is the total number of violations for this subscription, including
+ * this one. `demoted` is true if this violation caused the subscription to be demoted
+ * to background delivery.
+ */
+struct LatencyViolation {
+    const void* subscriber;
+    std::string_view event_type_name;
+    std::chrono::nanoseconds latency;
+    std::chrono::nanoseconds budget;
+    std::uint32_t violation_count;
+    bool demoted;
+};
+
+/**
+ * Watches event subscriptions that have a latency budget, as set by
+ * `EventDispatcher::set_latency_budget`, and reports every handler call that exceeds it.
+ *
+ * If constructed with a non-zero `demotion_threshold`, a subscription is demoted once it
+ * reaches that many violations. Events for a demoted subscription are no longer handled
+ * inside `EventDispatcher::dispatch`. Instead, a copy of each event is queued and handled
+ * when `run_demoted` is next called, typically from a background thread. Only copyable
+ * event types can be demoted. At most `demoted_capacity` events are queued, and
+ * `overflow_policy` decides what happens to events demoted while the queue is full.
+ *
+ * Refer to the "Latency Watchdog" section of `README.md` for example usage.
+ */
+class LatencyWatchdog {
+
+public:
+
+    using ViolationHandler = std::function<void(const LatencyViolation&)>;
+
+    static constexpr std::size_t DEFAULT_DEMOTED_CAPACITY = 4096;
+
+    explicit LatencyWatchdog(ViolationHandler violation_handler = {},
+                             std::uint32_t demotion_threshold = 0,
+                             std::size_t demoted_capacity = DEFAULT_DEMOTED_CAPACITY,
+                             OverflowPolicy overflow_policy = OverflowPolicy::DROP_OLDEST);
+
+    /**
+     * Handles all currently queued events for demoted subscriptions, returning how many
+     * were handled.
+     *
+     * A subscriber must not be destroyed while `run_demoted` may be handling its events.
+     */
+    std::size_t run_demoted();
+
+    std::size_t get_demoted_backlog() const;
+    QueueMetrics get_demoted_queue_metrics() const;
+    std::uint64_t get_violation_count() const;
+    std::uint32_t get_demotion_threshold() const;
+
+private:
+
+    template<class, class, class>
+    friend class BasicEventDispatcher;
+
+    struct _DemotedDelivery_ {
+        const void* subscriber;
+        TypeId type_id;
+        std::function<void()> deliver;
+    };
+
+    void _report(const LatencyViolation& violation);
+    void _post_demoted(const void* subscriber, TypeId type_id, std::function<void()> deliver);
+    void _forget(const void* subscriber, TypeId type_id);
+
+    ViolationHandler _violation_handler;
+    std::uint32_t _demotion_threshold;
+    std::atomic<std::uint64_t> _violation_count { 0 };
+
+    BoundedQueue<_DemotedDelivery_> _demoted_queue;
+};
+
+
+inline LatencyWatchdog::LatencyWatchdog(ViolationHandler violation_handler,
+                                        std::uint32_t demotion_threshold,
+                                        std::size_t demoted_capacity,
+                                        OverflowPolicy overflow_policy)
+    : _violation_handler(std::move(violation_handler))
+    , _demotion_threshold(demotion_threshold)
+    , _demoted_queue(demoted_capacity, overflow_policy)
+{
+}
+
+inline std::size_t LatencyWatchdog::run_demoted()
+{
+    std::size_t handled_count = 0;
+
+    while (auto delivery = _demoted_queue.try_pop()) {
+        delivery->deliver();
+        ++handled_count;
+    }
+
+    return handled_count;
+}
+
+inline std::size_t LatencyWatchdog::get_demoted_backlog() const
+{
+    return _demoted_queue.get_depth();
+}
+
+inline QueueMetrics LatencyWatchdog::get_demoted_queue_metrics() const
+{
+    return _demoted_queue.get_metrics();
+}
+
+inline std::uint64_t LatencyWatchdog::get_violation_count() const
+{
+    return _violation_count.load(std::memory_order_relaxed);
+}
+
+inline std::uint32_t LatencyWatchdog::get_demotion_threshold() const
+{
+    return _demotion_threshold;
+}
+
+inline void LatencyWatchdog::_report(const LatencyViolation& violation)
+{
+    _violation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (_violation_handler) {
+        _violation_handler(violation);
+    }
+}
+
+inline void LatencyWatchdog::_post_demoted(const void* subscriber, TypeId type_id, std::function<void()> deliver)
+{
+    _demoted_queue.push({ subscriber, type_id, std::move(deliver) });
+}
+
+inline void LatencyWatchdog::_forget(const void* subscriber, TypeId type_id)
+{
+    _demoted_queue.erase_if([subscriber, type_id](const _DemotedDelivery_& delivery) {
+        return delivery.subscriber == subscriber && delivery.type_id == type_id;
+    });
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,482 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_recorder.h"
+#include "event_type_registry.h"
+#include "shared/dispatchula_type_info.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace dispatch {
+
+
+/**
+ * The layout of an event journal file, shared by EventJournalWriter and EventJournalReader.
+ *
+ * A journal is a header followed by one record per event, each holding the event's TypeId
+ * hash, the nanoseconds between the journal's creation and the event's dispatch, and the
+ * event's bytes, padded to 8 bytes. `end_offset` is only advanced once a record is fully
+ * written, so a journal left by a crashed writer can still be read up to its last record.
+ *
+ * Clients should not use this class.
+ */
+struct _EventJournalFormat_ {
+
+    static constexpr std::uint64_t MAGIC = 0x6c6e72756f6a6468; // "hdjournl"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t RECORD_ALIGNMENT = 8;
+
+    struct Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::uint64_t end_offset;
+    };
+
+    struct RecordHeader {
+        std::uint64_t type_hash;
+        std::uint64_t timestamp_ns;
+        std::uint32_t event_size;
+        std::uint32_t reserved;
+    };
+
+    static constexpr std::size_t get_record_size(std::size_t event_size)
+    {
+        return (sizeof(RecordHeader) + event_size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    }
+};
+
+/**
+ * Appends trivially copyable events to a memory mapped journal file.
+ *
+ * Set a writer on an EventDispatcher with `EventDispatcher::set_recorder` to record every
+ * trivially copyable event it dispatches, or call `append` directly. Appending is thread
+ * safe, and only makes a system call when the file has to grow, which doubles its size.
+ * The file is truncated to the end of its last record when the writer is destroyed.
+ *
+ * Refer to the "Event Journal" section of `README.md` for example usage.
+ */
+class EventJournalWriter : public EventRecorder {
+
+public:
+
+    static constexpr std::size_t INITIAL_FILE_SIZE = std::size_t { 1 } << 20;
+
+    /**
+     * Creates the journal file at `path`, replacing any existing file.
+     */
+    static std::expected<EventJournalWriter, std::error_code> create(const std::filesystem::path& path);
+
+    EventJournalWriter(EventJournalWriter&& other) noexcept;
+    EventJournalWriter& operator=(EventJournalWriter&&) = delete;
+    ~EventJournalWriter() override;
+
+    /**
+     * Returns false, appending nothing, if the file could not be grown to fit the event.
+     */
+    template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+    bool append(const EVENT_TYPE& event);
+
+    void record_event(TypeId type_id, std::span<const std::byte> event_bytes) override;
+
+    std::uint64_t get_record_count() const;
+
+private:
+
+    EventJournalWriter(int file_descriptor, void* mapping, std::size_t mapping_size);
+
+    bool _append(std::uint64_t type_hash, std::span<const std::byte> event_bytes);
+    bool _grow_to_fit(std::size_t size);
+
+    _EventJournalFormat_::Header& _get_header() const;
+
+    int _file_descriptor = -1;
+    void* _mapping = nullptr;
+    std::size_t _mapping_size = 0;
+
+    std::chrono::steady_clock::time_point _start_time = std::chrono::steady_clock::now();
+    std::uint64_t _record_count = 0;
+    std::unique_ptr<std::mutex> _append_mutex = std::make_unique<std::mutex>();
+};
+
+/**
+ * Reads a journal written by an EventJournalWriter, and replays it through an event
+ * dispatcher.
+ *
+ * Refer to the "Event Journal" section of `README.md` for example usage.
+ */
+class EventJournalReader {
+
+public:
+
+    static constexpr double MAXIMUM_SPEED = std::numeric_limits<double>::infinity();
+
+    static std::expected<EventJournalReader, std::error_code> open(const std::filesystem::path& path);
+
+    EventJournalReader(EventJournalReader&& other) noexcept;
+    EventJournalReader& operator=(EventJournalReader&&) = delete;
+    ~EventJournalReader();
+
+    /**
+     * Dispatches every recorded event of a type registered in `event_type_registry`, in the
+     * order they were recorded, returning how many were dispatched.
+     *
+     * A `speed` of 1.0 waits between events as long as the recording did, 2.0 waits half as
+     * long, and MAXIMUM_SPEED does not wait at all.
+     */
+    template<class EVENT_DISPATCHER_TYPE>
+    std::size_t replay(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, double speed = 1.0) const;
+
+    std::uint64_t get_record_count() const;
+    std::chrono::nanoseconds get_duration() const;
+
+private:
+
+    EventJournalReader(int file_descriptor, const void* mapping, std::size_t mapping_size);
+
+    template<class RECORD_FUNCTION_TYPE>
+    void _for_each_record(RECORD_FUNCTION_TYPE record_function) const;
+
+    int _file_descriptor = -1;
+    const void* _mapping = nullptr;
+    std::size_t _mapping_size = 0;
+    std::size_t _end_offset = 0;
+
+    std::uint64_t _record_count = 0;
+    std::chrono::nanoseconds _duration { 0 };
+};
+
+
+inline std::expected<EventJournalWriter, std::error_code> EventJournalWriter::create(const std::filesystem::path& path)
+{
+    const int file_descriptor = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0644);
+
+    if (file_descriptor == -1) {
+        return std::unexpected(std::error_code { errno, std::system_category() });
+    }
+
+    void* mapping = MAP_FAILED;
+
+    if (::ftruncate(file_descriptor, INITIAL_FILE_SIZE) == 0) {
+        mapping = ::mmap(nullptr, INITIAL_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    }
+
+    if (mapping == MAP_FAILED) {
+        const std::error_code error { errno, std::system_category() };
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    new (mapping) _EventJournalFormat_::Header {
+        .magic = _EventJournalFormat_::MAGIC,
+        .version = _EventJournalFormat_::VERSION,
+        .reserved = 0,
+        .end_offset = sizeof(_EventJournalFormat_::Header),
+    };
+
+    return EventJournalWriter { file_descriptor, mapping, INITIAL_FILE_SIZE };
+}
+
+inline EventJournalWriter::EventJournalWriter(int file_descriptor, void* mapping, std::size_t mapping_size)
+    : _file_descriptor(file_descriptor)
+    , _mapping(mapping)
+    , _mapping_size(mapping_size)
+{
+}
+
+inline EventJournalWriter::EventJournalWriter(EventJournalWriter&& other) noexcept
+    : _file_descriptor(std::exchange(other._file_descriptor, -1))
+    , _mapping(std::exchange(other._mapping, nullptr))
+    , _mapping_size(std::exchange(other._mapping_size, 0))
+    , _start_time(other._start_time)
+    , _record_count(other._record_count)
+    , _append_mutex(std::move(other._append_mutex))
+{
+}
+
+inline EventJournalWriter::~EventJournalWriter()
+{
+    if (_mapping != nullptr) {
+        const auto end_offset = _get_header().end_offset;
+        ::munmap(_mapping, _mapping_size);
+        static_cast<void>(::ftruncate(_file_descriptor, static_cast<::off_t>(end_offset)));
+    }
+
+    if (_file_descriptor != -1) {
+        ::close(_file_descriptor);
+    }
+}
+
+template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+inline bool EventJournalWriter::append(const EVENT_TYPE& event)
+{
+    return _append(type_id_v<EVENT_TYPE>.hash, std::as_bytes(std::span { &event, 1 }));
+}
+
+inline void EventJournalWriter::record_event(TypeId type_id, std::span<const std::byte> event_bytes)
+{
+    _append(type_id.hash, event_bytes);
+}
+
+inline std::uint64_t EventJournalWriter::get_record_count() const
+{
+    std::lock_guard lock { *_append_mutex };
+    return _record_count;
+}
+
+inline bool EventJournalWriter::_append(std::uint64_t type_hash, std::span<const std::byte> event_bytes)
+{
+    const auto timestamp = std::chrono::steady_clock::now() - _start_time;
+    const auto record_size = _EventJournalFormat_::get_record_size(event_bytes.size());
+
+    std::lock_guard lock { *_append_mutex };
+
+    const auto record_offset = _get_header().end_offset;
+
+    if (!_grow_to_fit(record_offset + record_size)) {
+        return false;
+    }
+
+    auto record = static_cast<std::byte*>(_mapping) + record_offset;
+
+    const _EventJournalFormat_::RecordHeader record_header {
+        .type_hash = type_hash,
+        .timestamp_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp).count()),
+        .event_size = static_cast<std::uint32_t>(event_bytes.size()),
+        .reserved = 0,
+    };
+
+    std::memcpy(record, &record_header, sizeof(record_header));
+    std::memcpy(record + sizeof(record_header), event_bytes.data(), event_bytes.size());
+
+    std::atomic_ref(_get_header().end_offset).store(record_offset + record_size, std::memory_order_release);
+    ++_record_count;
+
+    return true;
+}
+
+inline bool EventJournalWriter::_grow_to_fit(std::size_t size)
+{
+    if (size <= _mapping_size) {
+        return true;
+    }
+
+    auto new_mapping_size = _mapping_size;
+
+    while (new_mapping_size < size) {
+        new_mapping_size *= 2;
+    }
+
+    if (::ftruncate(_file_descriptor, static_cast<::off_t>(new_mapping_size)) == -1) {
+        return false;
+    }
+
+    void* new_mapping = ::mremap(_mapping, _mapping_size, new_mapping_size, MREMAP_MAYMOVE);
+
+    if (new_mapping == MAP_FAILED) {
+        return false;
+    }
+
+    _mapping = new_mapping;
+    _mapping_size = new_mapping_size;
+
+    return true;
+}
+
+inline _EventJournalFormat_::Header& EventJournalWriter::_get_header() const
+{
+    return *std::launder(static_cast<_EventJournalFormat_::Header*>(_mapping));
+}
+
+inline std::expected<EventJournalReader, std::error_code> EventJournalReader::open(const std::filesystem::path& path)
+{
+    const int file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file_descriptor == -1) {
+        return std::unexpected(std::error_code { errno, std::system_category() });
+    }
+
+    struct stat file_status {};
+
+    if (::fstat(file_descriptor, &file_status) == -1) {
+        const std::error_code error { errno, std::system_category() };
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    const auto mapping_size = static_cast<std::size_t>(file_status.st_size);
+
+    if (mapping_size < sizeof(_EventJournalFormat_::Header)) {
+        ::close(file_descriptor);
+        return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+    }
+
+    const void* mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+
+    if (mapping == MAP_FAILED) {
+        const std::error_code error { errno, std::system_category() };
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    EventJournalReader reader { file_descriptor, mapping, mapping_size };
+
+    _EventJournalFormat_::Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    if (header.magic != _EventJournalFormat_::MAGIC
+        || header.version != _EventJournalFormat_::VERSION
+        || header.end_offset > mapping_size) {
+        return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+    }
+
+    reader._end_offset = header.end_offset;
+
+    reader._for_each_record([&reader](const _EventJournalFormat_::RecordHeader& record_header, const std::byte*) {
+        ++reader._record_count;
+        reader._duration = std::chrono::nanoseconds(record_header.timestamp_ns);
+    });
+
+    return reader;
+}
+
+inline EventJournalReader::EventJournalReader(int file_descriptor, const void* mapping, std::size_t mapping_size)
+    : _file_descriptor(file_descriptor)
+    , _mapping(mapping)
+    , _mapping_size(mapping_size)
+{
+}
+
+inline EventJournalReader::EventJournalReader(EventJournalReader&& other) noexcept
+    : _file_descriptor(std::exchange(other._file_descriptor, -1))
+    , _mapping(std::exchange(other._mapping, nullptr))
+    , _mapping_size(std::exchange(other._mapping_size, 0))
+    , _end_offset(other._end_offset)
+    , _record_count(other._record_count)
+    , _duration(other._duration)
+{
+}
+
+inline EventJournalReader::~EventJournalReader()
+{
+    if (_mapping != nullptr) {
+        ::munmap(const_cast<void*>(_mapping), _mapping_size);
+    }
+
+    if (_file_descriptor != -1) {
+        ::close(_file_descriptor);
+    }
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t EventJournalReader::replay(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, double speed) const
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    const bool wait_between_events = speed > 0.0 && speed != MAXIMUM_SPEED;
+
+    // Records are only 8 byte aligned in the file, so each event is copied to this buffer
+    std::unique_ptr<std::max_align_t[]> event_buffer;
+    std::size_t event_buffer_size = 0;
+
+    std::size_t dispatched_count = 0;
+
+    _for_each_record([&](const _EventJournalFormat_::RecordHeader& record_header, const std::byte* event_bytes) {
+        if (!event_type_registry.is_registered(record_header.type_hash)) {
+            return;
+        }
+
+        if (wait_between_events) {
+            const auto scaled_timestamp = std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(record_header.timestamp_ns) / speed));
+            std::this_thread::sleep_until(start_time + scaled_timestamp);
+        }
+
+        if (record_header.event_size > event_buffer_size) {
+            event_buffer_size = record_header.event_size;
+            event_buffer = std::make_unique<std::max_align_t[]>(event_buffer_size / sizeof(std::max_align_t) + 1);
+        }
+
+        const auto event_buffer_bytes = reinterpret_cast<std::byte*>(event_buffer.get());
+        std::memcpy(event_buffer_bytes, event_bytes, record_header.event_size);
+
+        if (event_type_registry.dispatch(event_dispatcher, record_header.type_hash, { event_buffer_bytes, record_header.event_size })) {
+            ++dispatched_count;
+        }
+    });
+
+    return dispatched_count;
+}
+
+inline std::uint64_t EventJournalReader::get_record_count() const
+{
+    return _record_count;
+}
+
+inline std::chrono::nanoseconds EventJournalReader::get_duration() const
+{
+    return _duration;
+}
+
+template<class RECORD_FUNCTION_TYPE>
+inline void EventJournalReader::_for_each_record(RECORD_FUNCTION_TYPE record_function) const
+{
+    const auto journal = static_cast<const std::byte*>(_mapping);
+    auto record_offset = sizeof(_EventJournalFormat_::Header);
+
+    while (record_offset + sizeof(_EventJournalFormat_::RecordHeader) <= _end_offset) {
+        _EventJournalFormat_::RecordHeader record_header;
+        std::memcpy(&record_header, journal + record_offset, sizeof(record_header));
+
+        const auto record_size = _EventJournalFormat_::get_record_size(record_header.event_size);
+
+        if (record_offset + record_size > _end_offset) {
+            break;
+        }
+
+        record_function(record_header, journal + record_offset + sizeof(record_header));
+        record_offset += record_size;
+    }
+}
+
+
+} // namespace dispatch
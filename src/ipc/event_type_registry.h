@@ -0,0 +1,134 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event/event_dispatcher.h"
+#include "shared/dispatchula_type_info.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+
+
+namespace dispatch {
+
+
+/**
+ * Event types that can be copied between processes as raw bytes. Their alignment must not
+ * exceed `alignof(std::max_align_t)`, the alignment of every receive buffer.
+ */
+template<class EVENT_TYPE>
+concept _is_raw_event_type_ = std::is_trivially_copyable_v<EVENT_TYPE> && alignof(EVENT_TYPE) <= alignof(std::max_align_t);
+
+/**
+ * Maps the `TypeId` hashes of trivially copyable event types to functions that dispatch
+ * them from raw bytes, for receiving events written by another process.
+ *
+ * TypeId hashes are stable across processes built with the same compiler, so they are the
+ * only type information sent with each event. Each receiving process registers the event
+ * types it wants, and events of any other type are skipped. EVENT_DISPATCHER_TYPE is the
+ * BasicEventDispatcher configuration the registered types are dispatched with.
+ */
+template<class EVENT_DISPATCHER_TYPE = EventDispatcher>
+class EventTypeRegistry {
+
+public:
+
+    /**
+     * Returns false only if EVENT_TYPE's TypeId hash collides with a different registered
+     * type's.
+     */
+    template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+    bool register_event_type();
+
+    bool is_registered(std::uint64_t type_hash) const;
+
+    /**
+     * Dispatches the event held in `event_bytes` with `event_dispatcher`. `event_bytes` must
+     * be aligned to `alignof(std::max_align_t)`. Returns false, dispatching nothing, if the
+     * type is not registered or `event_bytes` is not the size of the registered type.
+     */
+    bool dispatch(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::uint64_t type_hash, std::span<const std::byte> event_bytes) const;
+
+private:
+
+    struct _RegisteredEventType_ {
+        TypeId type_id;
+        std::size_t size;
+        void (*dispatch)(const EVENT_DISPATCHER_TYPE& event_dispatcher, const std::byte* event_bytes);
+    };
+
+    template<class EVENT_TYPE>
+    static void _dispatch_event_bytes(const EVENT_DISPATCHER_TYPE& event_dispatcher, const std::byte* event_bytes);
+
+    std::unordered_map<std::uint64_t, _RegisteredEventType_> _event_type_map {};
+};
+
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+inline bool EventTypeRegistry<EVENT_DISPATCHER_TYPE>::register_event_type()
+{
+    constexpr auto type_id = type_id_v<EVENT_TYPE>;
+
+    const auto [event_type_iter, inserted] = _event_type_map.try_emplace(type_id.hash, _RegisteredEventType_ {
+        type_id,
+        sizeof(EVENT_TYPE),
+        &_dispatch_event_bytes<EVENT_TYPE>,
+    });
+
+    return inserted || event_type_iter->second.type_id == type_id;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline bool EventTypeRegistry<EVENT_DISPATCHER_TYPE>::is_registered(std::uint64_t type_hash) const
+{
+    return _event_type_map.contains(type_hash);
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline bool EventTypeRegistry<EVENT_DISPATCHER_TYPE>::dispatch(const EVENT_DISPATCHER_TYPE& event_dispatcher, std::uint64_t type_hash, std::span<const std::byte> event_bytes) const
+{
+    const auto event_type_iter = _event_type_map.find(type_hash);
+
+    if (event_type_iter == _event_type_map.end() || event_type_iter->second.size != event_bytes.size()) {
+        return false;
+    }
+
+    event_type_iter->second.dispatch(event_dispatcher, event_bytes.data());
+
+    return true;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+template<class EVENT_TYPE>
+inline void EventTypeRegistry<EVENT_DISPATCHER_TYPE>::_dispatch_event_bytes(const EVENT_DISPATCHER_TYPE& event_dispatcher, const std::byte* event_bytes)
+{
+    // The bytes were copied from an EVENT_TYPE, so the copy holds an EVENT_TYPE too
+    event_dispatcher.dispatch(*std::launder(reinterpret_cast<const EVENT_TYPE*>(event_bytes)));
+}
+
+
+} // namespace dispatch
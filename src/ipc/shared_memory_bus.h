@@ -0,0 +1,544 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include "event/event_dispatcher.h"
+#include "event_type_registry.h"
+#include "shared/dispatchula_type_info.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+namespace dispatch {
+
+
+/**
+ * A broadcast ring buffer of events in shared memory, for sending trivially copyable events
+ * between processes on one Linux host.
+ *
+ * Any number of processes may publish to and receive from the same bus. Every receiving
+ * `SharedMemoryBus` object sees every event published after it was created or opened, and
+ * dispatches the event types registered in an EventTypeRegistry with an event dispatcher.
+ *
+ * Each event is written to the next of `slot_count` fixed size slots with one memcpy. Each
+ * slot carries a sequence number, so receivers read published events with one memcpy into a
+ * local buffer, and detect events overwritten before they could read them. Publishing and
+ * polling make no system calls. Only `wait`, and publishing while another process waits,
+ * use a futex.
+ *
+ * The ring has no backpressure: a receiver that falls more than `slot_count` events behind
+ * loses the oldest events, and counts them in `get_lost_count`. A publisher that the ring
+ * laps while it is still writing an event holds its slot until it finishes, so the next
+ * publisher to that slot waits for it, and an event claimed after a later one is dropped as
+ * overwritten. A publisher that dies while writing an event stalls receivers at that event,
+ * and publishers at that slot.
+ *
+ * Refer to the "Shared Memory Bus" section of `README.md` for example usage.
+ */
+class SharedMemoryBus {
+
+public:
+
+    /**
+     * Creates a bus in new POSIX shared memory named `name` (e.g. "/my_bus"), for other
+     * processes to `open`.
+     */
+    static std::expected<SharedMemoryBus, std::error_code> create(const std::string& name, std::size_t slot_count, std::size_t max_event_size);
+
+    /**
+     * Creates a bus in an anonymous memfd. Child processes forked after this call share the
+     * bus, and other processes can open its file descriptor with `open_file_descriptor`.
+     */
+    static std::expected<SharedMemoryBus, std::error_code> create_anonymous(std::size_t slot_count, std::size_t max_event_size);
+
+    static std::expected<SharedMemoryBus, std::error_code> open(const std::string& name);
+
+    /**
+     * Opens the bus in `file_descriptor`, taking ownership of it.
+     */
+    static std::expected<SharedMemoryBus, std::error_code> open_file_descriptor(int file_descriptor);
+
+    /**
+     * Removes the name of a bus made with `create`. Processes that already opened it can
+     * keep using it.
+     */
+    static bool remove(const std::string& name);
+
+    SharedMemoryBus(SharedMemoryBus&& other) noexcept;
+    SharedMemoryBus& operator=(SharedMemoryBus&& other) noexcept;
+    ~SharedMemoryBus();
+
+    SharedMemoryBus(const SharedMemoryBus&) = delete;
+    SharedMemoryBus& operator=(const SharedMemoryBus&) = delete;
+
+    /**
+     * Returns false, publishing nothing, if EVENT_TYPE is larger than the bus's maximum
+     * event size.
+     */
+    template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+    bool publish(const EVENT_TYPE& event);
+
+    /**
+     * Dispatches up to `max_event_count` events published since the last call, returning how
+     * many were dispatched. Events of types not registered in `event_type_registry` are
+     * skipped.
+     */
+    template<class EVENT_DISPATCHER_TYPE>
+    std::size_t poll(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * Like `poll`, but first waits up to `timeout` for an event to be published if none are
+     * waiting to be read.
+     */
+    template<class EVENT_DISPATCHER_TYPE>
+    std::size_t wait(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, std::chrono::nanoseconds timeout);
+
+    std::uint64_t get_lost_count() const;
+    std::size_t get_slot_count() const;
+    std::size_t get_max_event_size() const;
+    int get_file_descriptor() const;
+
+private:
+
+    static constexpr std::uint64_t _MAGIC_ = 0x6c75686374617073; // "spatchul"
+    static constexpr std::uint32_t _VERSION_ = 1;
+    static constexpr std::size_t _CACHE_LINE_SIZE_ = 64;
+
+    struct _BusHeader_ {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t slot_size;
+        std::uint64_t slot_count;
+
+        alignas(_CACHE_LINE_SIZE_) std::atomic<std::uint64_t> claim_sequence;
+
+        alignas(_CACHE_LINE_SIZE_) std::atomic<std::uint32_t> wake_count;
+        std::atomic<std::uint32_t> waiter_count;
+    };
+
+    // A slot's state is 2n + 1 while event n is being written to it, and 2n + 2 once written
+    struct _SlotHeader_ {
+        std::atomic<std::uint64_t> state;
+        std::uint64_t type_hash;
+        std::uint32_t event_size;
+    };
+
+    static constexpr std::size_t _HEADER_SIZE_ = (sizeof(_BusHeader_) + _CACHE_LINE_SIZE_ - 1) / _CACHE_LINE_SIZE_ * _CACHE_LINE_SIZE_;
+    static constexpr std::size_t _EVENT_OFFSET_ = (sizeof(_SlotHeader_) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Shared memory atomics must be lock free to work across processes");
+
+    SharedMemoryBus(int file_descriptor, void* mapping, std::size_t mapping_size);
+
+    static std::expected<SharedMemoryBus, std::error_code> _create_in(int file_descriptor, std::size_t slot_count, std::size_t max_event_size);
+    static std::error_code _last_error();
+
+    bool _publish(std::uint64_t type_hash, const void* event, std::size_t event_size);
+    bool _has_unread_event() const;
+    void _skip_lost_events();
+
+    _BusHeader_& _get_header() const;
+    _SlotHeader_& _get_slot(std::uint64_t sequence) const;
+
+    int _file_descriptor = -1;
+    void* _mapping = nullptr;
+    std::size_t _mapping_size = 0;
+
+    std::uint64_t _read_sequence = 0;
+    std::uint64_t _lost_count = 0;
+    std::unique_ptr<std::max_align_t[]> _receive_buffer {};
+};
+
+
+inline std::expected<SharedMemoryBus, std::error_code> SharedMemoryBus::create(const std::string& name, std::size_t slot_count, std::size_t max_event_size)
+{
+    const int file_descriptor = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (file_descriptor == -1) {
+        return std::unexpected(_last_error());
+    }
+
+    auto bus = _create_in(file_descriptor, slot_count, max_event_size);
+
+    if (!bus.has_value()) {
+        ::shm_unlink(name.c_str());
+    }
+
+    return bus;
+}
+
+inline std::expected<SharedMemoryBus, std::error_code> SharedMemoryBus::create_anonymous(std::size_t slot_count, std::size_t max_event_size)
+{
+    const int file_descriptor = ::memfd_create("dispatchula_shared_memory_bus", MFD_CLOEXEC);
+
+    if (file_descriptor == -1) {
+        return std::unexpected(_last_error());
+    }
+
+    return _create_in(file_descriptor, slot_count, max_event_size);
+}
+
+inline std::expected<SharedMemoryBus, std::error_code> SharedMemoryBus::open(const std::string& name)
+{
+    const int file_descriptor = ::shm_open(name.c_str(), O_RDWR, 0);
+
+    if (file_descriptor == -1) {
+        return std::unexpected(_last_error());
+    }
+
+    return open_file_descriptor(file_descriptor);
+}
+
+inline std::expected<SharedMemoryBus, std::error_code> SharedMemoryBus::open_file_descriptor(int file_descriptor)
+{
+    struct stat file_status {};
+
+    if (::fstat(file_descriptor, &file_status) == -1) {
+        const auto error = _last_error();
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    const auto mapping_size = static_cast<std::size_t>(file_status.st_size);
+
+    if (mapping_size < _HEADER_SIZE_) {
+        ::close(file_descriptor);
+        return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+    }
+
+    void* mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+
+    if (mapping == MAP_FAILED) {
+        const auto error = _last_error();
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    SharedMemoryBus bus { file_descriptor, mapping, mapping_size };
+    const auto& header = bus._get_header();
+
+    if (header.magic != _MAGIC_
+        || header.version != _VERSION_
+        || _HEADER_SIZE_ + header.slot_count * header.slot_size > mapping_size) {
+        return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+    }
+
+    bus._receive_buffer = std::make_unique<std::max_align_t[]>(header.slot_size / sizeof(std::max_align_t) + 1);
+    bus._read_sequence = header.claim_sequence.load(std::memory_order_acquire);
+
+    return bus;
+}
+
+inline bool SharedMemoryBus::remove(const std::string& name)
+{
+    return ::shm_unlink(name.c_str()) == 0;
+}
+
+inline SharedMemoryBus::SharedMemoryBus(int file_descriptor, void* mapping, std::size_t mapping_size)
+    : _file_descriptor(file_descriptor)
+    , _mapping(mapping)
+    , _mapping_size(mapping_size)
+{
+}
+
+inline SharedMemoryBus::SharedMemoryBus(SharedMemoryBus&& other) noexcept
+    : _file_descriptor(std::exchange(other._file_descriptor, -1))
+    , _mapping(std::exchange(other._mapping, nullptr))
+    , _mapping_size(std::exchange(other._mapping_size, 0))
+    , _read_sequence(other._read_sequence)
+    , _lost_count(other._lost_count)
+    , _receive_buffer(std::move(other._receive_buffer))
+{
+}
+
+inline SharedMemoryBus& SharedMemoryBus::operator=(SharedMemoryBus&& other) noexcept
+{
+    std::swap(_file_descriptor, other._file_descriptor);
+    std::swap(_mapping, other._mapping);
+    std::swap(_mapping_size, other._mapping_size);
+    std::swap(_read_sequence, other._read_sequence);
+    std::swap(_lost_count, other._lost_count);
+    std::swap(_receive_buffer, other._receive_buffer);
+
+    return *this;
+}
+
+inline SharedMemoryBus::~SharedMemoryBus()
+{
+    if (_mapping != nullptr) {
+        ::munmap(_mapping, _mapping_size);
+    }
+
+    if (_file_descriptor != -1) {
+        ::close(_file_descriptor);
+    }
+}
+
+template<class EVENT_TYPE> requires _is_raw_event_type_<EVENT_TYPE>
+inline bool SharedMemoryBus::publish(const EVENT_TYPE& event)
+{
+    return _publish(type_id_v<EVENT_TYPE>.hash, &event, sizeof(EVENT_TYPE));
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t SharedMemoryBus::poll(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, std::size_t max_event_count)
+{
+    const auto max_event_size = get_max_event_size();
+    auto receive_buffer = reinterpret_cast<std::byte*>(_receive_buffer.get());
+
+    std::size_t dispatched_count = 0;
+
+    while (dispatched_count < max_event_count) {
+        auto& slot = _get_slot(_read_sequence);
+        const auto published_state = 2 * _read_sequence + 2;
+
+        const auto state = slot.state.load(std::memory_order_acquire);
+
+        if (state < published_state) {
+            break;
+        }
+
+        if (state > published_state) {
+            _skip_lost_events();
+            continue;
+        }
+
+        const auto type_hash = slot.type_hash;
+        const auto event_size = std::min<std::size_t>(slot.event_size, max_event_size);
+
+        std::memcpy(receive_buffer, reinterpret_cast<const std::byte*>(&slot) + _EVENT_OFFSET_, event_size);
+
+        // If the slot was overwritten during the copy, its state has changed
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.state.load(std::memory_order_relaxed) != published_state) {
+            _skip_lost_events();
+            continue;
+        }
+
+        ++_read_sequence;
+
+        if (event_type_registry.dispatch(event_dispatcher, type_hash, { receive_buffer, event_size })) {
+            ++dispatched_count;
+        }
+    }
+
+    return dispatched_count;
+}
+
+template<class EVENT_DISPATCHER_TYPE>
+inline std::size_t SharedMemoryBus::wait(const EventTypeRegistry<EVENT_DISPATCHER_TYPE>& event_type_registry, const EVENT_DISPATCHER_TYPE& event_dispatcher, std::chrono::nanoseconds timeout)
+{
+    if (!_has_unread_event()) {
+        auto& header = _get_header();
+
+        header.waiter_count.fetch_add(1, std::memory_order_seq_cst);
+        const auto wake_count = header.wake_count.load(std::memory_order_seq_cst);
+
+        // Checked again after registering as a waiter, so a publish in between either
+        // shows up here or wakes the futex
+        if (!_has_unread_event()) {
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            const ::timespec relative_timeout { static_cast<::time_t>(seconds.count()), static_cast<long>((timeout - seconds).count()) };
+
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&header.wake_count), FUTEX_WAIT, wake_count, &relative_timeout, nullptr, 0);
+        }
+
+        header.waiter_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return poll(event_type_registry, event_dispatcher);
+}
+
+inline std::uint64_t SharedMemoryBus::get_lost_count() const
+{
+    return _lost_count;
+}
+
+inline std::size_t SharedMemoryBus::get_slot_count() const
+{
+    return _get_header().slot_count;
+}
+
+inline std::size_t SharedMemoryBus::get_max_event_size() const
+{
+    return _get_header().slot_size - _EVENT_OFFSET_;
+}
+
+inline int SharedMemoryBus::get_file_descriptor() const
+{
+    return _file_descriptor;
+}
+
+inline std::expected<SharedMemoryBus, std::error_code> SharedMemoryBus::_create_in(int file_descriptor, std::size_t slot_count, std::size_t max_event_size)
+{
+    const auto slot_size = (_EVENT_OFFSET_ + max_event_size + _CACHE_LINE_SIZE_ - 1) / _CACHE_LINE_SIZE_ * _CACHE_LINE_SIZE_;
+    const auto mapping_size = _HEADER_SIZE_ + std::max<std::size_t>(slot_count, 1) * slot_size;
+
+    if (::ftruncate(file_descriptor, static_cast<::off_t>(mapping_size)) == -1) {
+        const auto error = _last_error();
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    void* mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+
+    if (mapping == MAP_FAILED) {
+        const auto error = _last_error();
+        ::close(file_descriptor);
+        return std::unexpected(error);
+    }
+
+    // The memory is zero filled, so every slot starts in state 0, before event 0 is written
+    auto header = new (mapping) _BusHeader_ {};
+    header->version = _VERSION_;
+    header->slot_size = static_cast<std::uint32_t>(slot_size);
+    header->slot_count = std::max<std::size_t>(slot_count, 1);
+
+    for (std::uint64_t slot_index = 0; slot_index < header->slot_count; ++slot_index) {
+        new (static_cast<std::byte*>(mapping) + _HEADER_SIZE_ + slot_index * slot_size) _SlotHeader_ {};
+    }
+
+    std::atomic_ref(header->magic).store(_MAGIC_, std::memory_order_release);
+
+    SharedMemoryBus bus { file_descriptor, mapping, mapping_size };
+    bus._receive_buffer = std::make_unique<std::max_align_t[]>(slot_size / sizeof(std::max_align_t) + 1);
+
+    return bus;
+}
+
+inline std::error_code SharedMemoryBus::_last_error()
+{
+    return { errno, std::system_category() };
+}
+
+inline bool SharedMemoryBus::_publish(std::uint64_t type_hash, const void* event, std::size_t event_size)
+{
+    if (event_size > get_max_event_size()) {
+        return false;
+    }
+
+    auto& header = _get_header();
+    const auto sequence = header.claim_sequence.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = _get_slot(sequence);
+    const auto writing_state = 2 * sequence + 1;
+
+    // Marks the slot as being written before overwriting it, so receivers copying the
+    // previous event in this slot see that it has changed. Only one publisher writes to a
+    // slot at a time, and a slot's state only ever moves forward.
+    auto state = slot.state.load(std::memory_order_relaxed);
+
+    while (true) {
+        // A later event has already claimed the slot, so this one counts as overwritten
+        if (state > writing_state) {
+            return true;
+        }
+
+        // An earlier event is still being written to the slot, by a publisher the ring lapped
+        if (state % 2 == 1) {
+            std::this_thread::yield();
+            state = slot.state.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (slot.state.compare_exchange_weak(state, writing_state, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type_hash = type_hash;
+    slot.event_size = static_cast<std::uint32_t>(event_size);
+    std::memcpy(reinterpret_cast<std::byte*>(&slot) + _EVENT_OFFSET_, event, event_size);
+
+    slot.state.store(2 * sequence + 2, std::memory_order_release);
+
+    // Pairs with the `waiter_count` increment in `wait`, so either the waiter sees this event,
+    // or this sees the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (header.waiter_count.load(std::memory_order_relaxed) != 0) {
+        header.wake_count.fetch_add(1, std::memory_order_relaxed);
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&header.wake_count), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    return true;
+}
+
+inline bool SharedMemoryBus::_has_unread_event() const
+{
+    return _get_slot(_read_sequence).state.load(std::memory_order_seq_cst) >= 2 * _read_sequence + 2;
+}
+
+inline void SharedMemoryBus::_skip_lost_events()
+{
+    const auto& header = _get_header();
+
+    // Moves on to the oldest event that has not yet been overwritten
+    const auto claim_sequence = header.claim_sequence.load(std::memory_order_acquire);
+    const auto oldest_sequence = claim_sequence > header.slot_count ? claim_sequence - header.slot_count : 0;
+    const auto next_read_sequence = std::max(oldest_sequence, _read_sequence + 1);
+
+    _lost_count += next_read_sequence - _read_sequence;
+    _read_sequence = next_read_sequence;
+}
+
+inline auto SharedMemoryBus::_get_header() const -> _BusHeader_&
+{
+    return *std::launder(static_cast<_BusHeader_*>(_mapping));
+}
+
+inline auto SharedMemoryBus::_get_slot(std::uint64_t sequence) const -> _SlotHeader_&
+{
+    const auto& header = _get_header();
+    auto slot_address = static_cast<std::byte*>(_mapping) + _HEADER_SIZE_ + (sequence % header.slot_count) * header.slot_size;
+
+    return *std::launder(reinterpret_cast<_SlotHeader_*>(slot_address));
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,323 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+namespace dispatch {
+
+
+template<class OBJECT_TYPE>
+class ObjectPool;
+
+
+/**
+ * Returns objects made by `ObjectPool::make_unique` to their pool instead of freeing them.
+ * A default constructed deleter deletes objects with `delete`.
+ */
+template<class OBJECT_TYPE>
+class ObjectPoolDeleter {
+
+public:
+
+    ObjectPoolDeleter() = default;
+    explicit ObjectPoolDeleter(ObjectPool<OBJECT_TYPE>* object_pool) : _object_pool(object_pool) {}
+
+    void operator()(OBJECT_TYPE* object) const;
+
+private:
+
+    ObjectPool<OBJECT_TYPE>* _object_pool = nullptr;
+};
+
+
+/**
+ * A unique_ptr to an object from an ObjectPool, which returns the object to the pool when
+ * destroyed. Can be used as a request's return type, e.g. `Request<PooledPtr<Mesh>>`.
+ */
+template<class OBJECT_TYPE>
+using PooledPtr = std::unique_ptr<OBJECT_TYPE, ObjectPoolDeleter<OBJECT_TYPE>>;
+
+
+/**
+ * A fixed number of preallocated slots for objects of OBJECT_TYPE, for request handlers that
+ * return `PooledPtr` or `std::shared_ptr` results, so that steady state requests never touch
+ * the global allocator.
+ *
+ * Free slots are kept on a lock free stack, so any thread may make objects and any thread may
+ * destroy them. Each slot has room for a `std::shared_ptr` control block as well as the object,
+ * so `make_shared` takes a single slot. When every slot is in use, objects are allocated from
+ * the global heap instead, and counted by `get_fallback_count`.
+ *
+ * The pool must outlive every object made from it.
+ *
+ * Refer to the "Object Pools" section of `README.md` for example usage.
+ */
+template<class OBJECT_TYPE>
+class ObjectPool {
+
+public:
+
+    explicit ObjectPool(std::size_t capacity);
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<OBJECT_TYPE, ARGUMENT_TYPE_LIST...>
+    PooledPtr<OBJECT_TYPE> make_unique(ARGUMENT_TYPE_LIST&& ... argument_list);
+
+    /**
+     * Returns a shared_ptr whose object and control block share one slot, which is returned
+     * to the pool when the last shared_ptr or weak_ptr to it is destroyed.
+     */
+    template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<OBJECT_TYPE, ARGUMENT_TYPE_LIST...>
+    std::shared_ptr<OBJECT_TYPE> make_shared(ARGUMENT_TYPE_LIST&& ... argument_list);
+
+    std::size_t get_capacity() const;
+
+    /**
+     * Returns how many objects were allocated from the global heap because every slot was in use.
+     */
+    std::uint64_t get_fallback_count() const;
+
+private:
+
+    friend ObjectPoolDeleter<OBJECT_TYPE>;
+
+    /**
+     * Room left in each slot for a shared_ptr control block, which holds a vtable pointer,
+     * two reference counts and the allocator alongside the object.
+     */
+    static constexpr std::size_t CONTROL_BLOCK_ALLOWANCE = 64;
+    static constexpr std::size_t SLOT_ALIGNMENT = std::max(alignof(OBJECT_TYPE), alignof(std::max_align_t));
+    static constexpr std::size_t SLOT_SIZE = (sizeof(OBJECT_TYPE) + CONTROL_BLOCK_ALLOWANCE + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+    static constexpr std::uint32_t NO_SLOT_INDEX = UINT32_MAX;
+
+    struct alignas(SLOT_ALIGNMENT) _Slot_ {
+        std::byte storage[SLOT_SIZE];
+    };
+
+    template<class VALUE_TYPE>
+    class _Allocator_ {
+
+    public:
+
+        using value_type = VALUE_TYPE;
+
+        explicit _Allocator_(ObjectPool* object_pool) : _object_pool(object_pool) {}
+
+        template<class OTHER_VALUE_TYPE>
+        _Allocator_(const _Allocator_<OTHER_VALUE_TYPE>& other) : _object_pool(other._object_pool) {}
+
+        VALUE_TYPE* allocate(std::size_t count);
+        void deallocate(VALUE_TYPE* value, std::size_t count);
+
+        template<class OTHER_VALUE_TYPE>
+        bool operator==(const _Allocator_<OTHER_VALUE_TYPE>& other) const { return _object_pool == other._object_pool; }
+
+    private:
+
+        template<class>
+        friend class _Allocator_;
+
+        ObjectPool* _object_pool;
+    };
+
+    void* _allocate(std::size_t size, std::size_t alignment);
+    void _deallocate(void* storage, std::size_t size, std::size_t alignment);
+
+    _Slot_* _pop_free_slot();
+    void _push_free_slot(std::uint32_t slot_index);
+
+    static std::uint64_t _make_free_head(std::uint64_t previous_free_head, std::uint32_t slot_index);
+
+    std::size_t _capacity;
+    std::unique_ptr<_Slot_[]> _slot_list;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> _next_free_index_list;
+
+    /**
+     * The index of the first free slot in the low 32 bits, and a count of changes in the high
+     * 32 bits, so a slot popped and pushed back between a load and a compare exchange is noticed.
+     */
+    std::atomic<std::uint64_t> _free_head;
+    std::atomic<std::uint64_t> _fallback_count { 0 };
+};
+
+
+template<class OBJECT_TYPE>
+inline void ObjectPoolDeleter<OBJECT_TYPE>::operator()(OBJECT_TYPE* object) const
+{
+    if (_object_pool == nullptr) {
+        delete object;
+        return;
+    }
+
+    object->~OBJECT_TYPE();
+    _object_pool->_deallocate(object, sizeof(OBJECT_TYPE), alignof(OBJECT_TYPE));
+}
+
+template<class OBJECT_TYPE>
+inline ObjectPool<OBJECT_TYPE>::ObjectPool(std::size_t capacity)
+    : _capacity(std::min<std::size_t>(capacity, NO_SLOT_INDEX))
+    , _slot_list(std::make_unique<_Slot_[]>(_capacity))
+    , _next_free_index_list(std::make_unique<std::atomic<std::uint32_t>[]>(_capacity))
+    , _free_head(_capacity == 0 ? NO_SLOT_INDEX : 0)
+{
+    for (std::size_t slot_index = 0; slot_index < _capacity; ++slot_index) {
+        const auto next_free_index = slot_index + 1 < _capacity ? static_cast<std::uint32_t>(slot_index + 1) : NO_SLOT_INDEX;
+        _next_free_index_list[slot_index].store(next_free_index, std::memory_order_relaxed);
+    }
+}
+
+template<class OBJECT_TYPE>
+template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<OBJECT_TYPE, ARGUMENT_TYPE_LIST...>
+inline PooledPtr<OBJECT_TYPE> ObjectPool<OBJECT_TYPE>::make_unique(ARGUMENT_TYPE_LIST&& ... argument_list)
+{
+    // Returns the storage to the pool if the constructor throws
+    struct DeallocateGuard {
+        ObjectPool* object_pool;
+        void* storage;
+
+        ~DeallocateGuard()
+        {
+            if (storage != nullptr) {
+                object_pool->_deallocate(storage, sizeof(OBJECT_TYPE), alignof(OBJECT_TYPE));
+            }
+        }
+    };
+
+    DeallocateGuard deallocate_guard { this, _allocate(sizeof(OBJECT_TYPE), alignof(OBJECT_TYPE)) };
+    const auto object = ::new (deallocate_guard.storage) OBJECT_TYPE(std::forward<ARGUMENT_TYPE_LIST>(argument_list)...);
+    deallocate_guard.storage = nullptr;
+
+    return PooledPtr<OBJECT_TYPE>(object, ObjectPoolDeleter<OBJECT_TYPE>(this));
+}
+
+template<class OBJECT_TYPE>
+template<class ... ARGUMENT_TYPE_LIST> requires std::constructible_from<OBJECT_TYPE, ARGUMENT_TYPE_LIST...>
+inline std::shared_ptr<OBJECT_TYPE> ObjectPool<OBJECT_TYPE>::make_shared(ARGUMENT_TYPE_LIST&& ... argument_list)
+{
+    return std::allocate_shared<OBJECT_TYPE>(_Allocator_<OBJECT_TYPE>(this), std::forward<ARGUMENT_TYPE_LIST>(argument_list)...);
+}
+
+template<class OBJECT_TYPE>
+inline std::size_t ObjectPool<OBJECT_TYPE>::get_capacity() const
+{
+    return _capacity;
+}
+
+template<class OBJECT_TYPE>
+inline std::uint64_t ObjectPool<OBJECT_TYPE>::get_fallback_count() const
+{
+    return _fallback_count.load(std::memory_order_relaxed);
+}
+
+template<class OBJECT_TYPE>
+template<class VALUE_TYPE>
+inline VALUE_TYPE* ObjectPool<OBJECT_TYPE>::_Allocator_<VALUE_TYPE>::allocate(std::size_t count)
+{
+    return static_cast<VALUE_TYPE*>(_object_pool->_allocate(sizeof(VALUE_TYPE) * count, alignof(VALUE_TYPE)));
+}
+
+template<class OBJECT_TYPE>
+template<class VALUE_TYPE>
+inline void ObjectPool<OBJECT_TYPE>::_Allocator_<VALUE_TYPE>::deallocate(VALUE_TYPE* value, std::size_t count)
+{
+    _object_pool->_deallocate(value, sizeof(VALUE_TYPE) * count, alignof(VALUE_TYPE));
+}
+
+template<class OBJECT_TYPE>
+inline void* ObjectPool<OBJECT_TYPE>::_allocate(std::size_t size, std::size_t alignment)
+{
+    if (size <= SLOT_SIZE && alignment <= SLOT_ALIGNMENT) {
+        if (const auto slot = _pop_free_slot()) {
+            return slot->storage;
+        }
+    }
+
+    _fallback_count.fetch_add(1, std::memory_order_relaxed);
+
+    return ::operator new(size, std::align_val_t(alignment));
+}
+
+template<class OBJECT_TYPE>
+inline void ObjectPool<OBJECT_TYPE>::_deallocate(void* storage, std::size_t size, std::size_t alignment)
+{
+    const auto slot = static_cast<_Slot_*>(storage);
+
+    if (std::less_equal<>()(_slot_list.get(), slot) && std::less<>()(slot, _slot_list.get() + _capacity)) {
+        _push_free_slot(static_cast<std::uint32_t>(slot - _slot_list.get()));
+    }
+
+    else {
+        ::operator delete(storage, size, std::align_val_t(alignment));
+    }
+}
+
+template<class OBJECT_TYPE>
+inline auto ObjectPool<OBJECT_TYPE>::_pop_free_slot() -> _Slot_*
+{
+    auto free_head = _free_head.load(std::memory_order_acquire);
+
+    while (true) {
+        const auto slot_index = static_cast<std::uint32_t>(free_head);
+
+        if (slot_index == NO_SLOT_INDEX) {
+            return nullptr;
+        }
+
+        const auto next_free_index = _next_free_index_list[slot_index].load(std::memory_order_relaxed);
+
+        if (_free_head.compare_exchange_weak(free_head, _make_free_head(free_head, next_free_index), std::memory_order_acquire, std::memory_order_acquire)) {
+            return &_slot_list[slot_index];
+        }
+    }
+}
+
+template<class OBJECT_TYPE>
+inline void ObjectPool<OBJECT_TYPE>::_push_free_slot(std::uint32_t slot_index)
+{
+    auto free_head = _free_head.load(std::memory_order_relaxed);
+
+    do {
+        _next_free_index_list[slot_index].store(static_cast<std::uint32_t>(free_head), std::memory_order_relaxed);
+    } while (!_free_head.compare_exchange_weak(free_head, _make_free_head(free_head, slot_index), std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<class OBJECT_TYPE>
+inline std::uint64_t ObjectPool<OBJECT_TYPE>::_make_free_head(std::uint64_t previous_free_head, std::uint32_t slot_index)
+{
+    const auto change_count = (previous_free_head >> 32) + 1;
+    return (change_count << 32) | slot_index;
+}
+
+
+} // namespace dispatch
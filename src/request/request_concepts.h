@@ -45,7 +45,7 @@ template <class T>
 concept _is_shared_pointer_ = std::same_as<T, std::shared_ptr<typename T::element_type>>;
 
 template <class T>
-concept _is_unique_pointer_ = std::same_as<T, std::unique_ptr<typename T::element_type>>;
+concept _is_unique_pointer_ = std::same_as<T, std::unique_ptr<typename T::element_type, typename T::deleter_type>>;
 
 template <class T>
 concept _is_optional_ = std::same_as<T, std::optional<typename T::value_type>>;
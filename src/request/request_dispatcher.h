@@ -22,26 +22,53 @@
 
 
 #include "request_subscriber.h"
+#include "shared/dispatch_policies.h"
+#include "shared/dispatch_tracer.h"
+#include "shared/dispatchula_type_info.h"
 
 #include <algorithm>
 #include <concepts>
 #include <map>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
-#include <typeindex>
-#include <vector>
+#include <shared_mutex>
 
 
 namespace dispatch {
 
 
-class RequestDispatcher {
+/**
+ * Dispatches requests to the subscriber to their type.
+ *
+ * THREADING_POLICY, STORAGE_POLICY and INSTRUMENTATION_POLICY select how subscriptions are
+ * guarded, how they are looked up, and what is recorded about each dispatch. Refer to
+ * `shared/dispatch_policies.h` for the available policies. `RequestDispatcher` is the single
+ * threaded, ordered map based configuration, traced by the DispatchTracer.
+ */
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicRequestDispatcher {
 
 public:
 
+    BasicRequestDispatcher() = default;
+
+    /**
+     * Allocates the dispatcher's lookup table from `memory_resource` instead of the default
+     * memory resource. `memory_resource` must outlive this dispatcher.
+     */
+    explicit BasicRequestDispatcher(std::pmr::memory_resource* memory_resource);
+
     bool subscribe(_RequestSubscriberBase_* subscriber);
 
     void unsubscribe(_RequestSubscriberBase_* subscriber);
 
+    template<class STATIC_REQUEST_SUBSCRIBER_TYPE> requires _is_static_request_subscriber_<STATIC_REQUEST_SUBSCRIBER_TYPE>
+    bool subscribe(STATIC_REQUEST_SUBSCRIBER_TYPE* subscriber);
+
+    template<class STATIC_REQUEST_SUBSCRIBER_TYPE> requires _is_static_request_subscriber_<STATIC_REQUEST_SUBSCRIBER_TYPE>
+    void unsubscribe(STATIC_REQUEST_SUBSCRIBER_TYPE* subscriber);
+
     template<class REQUEST_TYPE, class SUBSCRIBER_TYPE> requires _convertable_to_subscriber_of_<SUBSCRIBER_TYPE, REQUEST_TYPE>
     bool subscribe(SUBSCRIBER_TYPE* subscriber);
 
@@ -99,77 +126,156 @@ public:
     template<class REQUEST_TYPE> requires _has_value_return_type_<REQUEST_TYPE>
     auto dispatch(const REQUEST_TYPE& request) const -> std::optional<typename REQUEST_TYPE::_RETURN_TYPE_>;
 
+    /**
+     * Dispatches to the first appropriate subscriber in list, which writes its result to
+     * `output` instead of returning it. Returns false, leaving `output` as it was, if there is no
+     * subscriber or no result.
+     *
+     * `output` is the value held by the request's return type, e.g. `T` for `Request<T>`,
+     * `Request<std::unique_ptr<T>>` or `Request<std::expected<T, E>>`. Subscribers that
+     * implement `handle_request_into(const RequestType&, T& output)` can fill `output` in place,
+     * reusing its storage across calls. Other subscribers' results are moved into `output`.
+     */
+    template<class REQUEST_TYPE> requires _has_request_output_<REQUEST_TYPE>
+    bool dispatch_into(const REQUEST_TYPE& request, _request_output_t_<REQUEST_TYPE>& output) const;
+
 private:
 
-    bool _try_subscribe_to_type_id(_RequestSubscriberBase_* subscriber, std::type_index type_id);
-    void _unsubscribe_from_type_id(_RequestSubscriberBase_* subscriber, std::type_index type_id);
+    using _InstrumentationScope_ = typename INSTRUMENTATION_POLICY::scope_type;
+
+    struct _RequestSubscription_ {
+        const void* subscriber;
+        _RequestHandler_ handler;
+    };
+
+    template<class REQUEST_TYPE>
+    static auto _handle_request(const _RequestSubscription_& subscription, const REQUEST_TYPE& request) -> typename REQUEST_TYPE::_RETURN_TYPE_;
 
-    std::map<std::type_index, _RequestSubscriberBase_*> _subscriber_map {};
+    template<class SUBSCRIBER_TYPE>
+    static const void* _get_subscriber_key(SUBSCRIBER_TYPE* subscriber);
+
+    template<class REQUEST_TYPE, class SUBSCRIBER_TYPE>
+    static _RequestHandler_ _get_request_handler(SUBSCRIBER_TYPE* subscriber);
+
+    bool _try_subscribe_to_type_id(const void* subscriber, _RequestHandler_ handler, TypeId type_id);
+    void _unsubscribe_from_type_id(const void* subscriber, TypeId type_id);
+
+    typename STORAGE_POLICY::template map_type<TypeId, _RequestSubscription_> _subscriber_map {};
+    mutable typename THREADING_POLICY::mutex_type _mutex {};
 };
 
 
-inline bool RequestDispatcher::subscribe(_RequestSubscriberBase_* subscriber)
+using RequestDispatcher = BasicRequestDispatcher<SingleThreaded, OrderedStorage, TracingInstrumentation>;
+
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::BasicRequestDispatcher(std::pmr::memory_resource* memory_resource)
+    : _subscriber_map(memory_resource)
+{}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(_RequestSubscriberBase_* subscriber)
 {
-    const auto& type_id_list = subscriber->_get_request_type_id_list();
+    const auto type_id_list = subscriber->_get_request_type_id_list();
 
     bool subscribe_success = true;
 
-    for (auto type_id : type_id_list) {
-        subscribe_success &= _try_subscribe_to_type_id(subscriber, type_id);
+    const std::unique_lock lock { _mutex };
+
+    for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+        auto handler = subscriber->_get_request_handler(type_index);
+        subscribe_success &= _try_subscribe_to_type_id(subscriber, handler, type_id_list[type_index]);
     }
 
     return subscribe_success;
 }
 
-inline void RequestDispatcher::unsubscribe(_RequestSubscriberBase_* subscriber)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(_RequestSubscriberBase_* subscriber)
 {
-    const auto& type_id_list = subscriber->_get_request_type_id_list();
+    const auto type_id_list = subscriber->_get_request_type_id_list();
+
+    const std::unique_lock lock { _mutex };
 
-    for (auto type_id : type_id_list) {
+    for (const auto& type_id : type_id_list) {
         _unsubscribe_from_type_id(subscriber, type_id);
     }
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class STATIC_REQUEST_SUBSCRIBER_TYPE> requires _is_static_request_subscriber_<STATIC_REQUEST_SUBSCRIBER_TYPE>
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(STATIC_REQUEST_SUBSCRIBER_TYPE* subscriber)
+{
+    auto static_subscriber = static_cast<_static_request_subscriber_base_t_<STATIC_REQUEST_SUBSCRIBER_TYPE>*>(subscriber);
+    const auto& type_id_list = static_subscriber->_request_type_id_list;
+
+    bool subscribe_success = true;
+
+    const std::unique_lock lock { _mutex };
+
+    for (std::size_t type_index = 0; type_index < type_id_list.size(); ++type_index) {
+        auto handler = static_subscriber->_get_request_handler(type_index);
+        subscribe_success &= _try_subscribe_to_type_id(static_subscriber, handler, type_id_list[type_index]);
+    }
+
+    return subscribe_success;
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class STATIC_REQUEST_SUBSCRIBER_TYPE> requires _is_static_request_subscriber_<STATIC_REQUEST_SUBSCRIBER_TYPE>
+inline void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(STATIC_REQUEST_SUBSCRIBER_TYPE* subscriber)
+{
+    auto static_subscriber = static_cast<_static_request_subscriber_base_t_<STATIC_REQUEST_SUBSCRIBER_TYPE>*>(subscriber);
+
+    const std::unique_lock lock { _mutex };
+
+    for (const auto& type_id : static_subscriber->_request_type_id_list) {
+        _unsubscribe_from_type_id(static_subscriber, type_id);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE, class SUBSCRIBER_TYPE> requires _convertable_to_subscriber_of_<SUBSCRIBER_TYPE, REQUEST_TYPE>
-inline bool RequestDispatcher::subscribe(SUBSCRIBER_TYPE* subscriber)
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(SUBSCRIBER_TYPE* subscriber)
 {
-    return _try_subscribe_to_type_id(subscriber, typeid(REQUEST_TYPE));
+    const std::unique_lock lock { _mutex };
+    return _try_subscribe_to_type_id(_get_subscriber_key(subscriber), _get_request_handler<REQUEST_TYPE>(subscriber), type_id_v<REQUEST_TYPE>);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE, class SUBSCRIBER_TYPE> requires  _convertable_to_subscriber_of_<SUBSCRIBER_TYPE, REQUEST_TYPE>
-inline void RequestDispatcher::unsubscribe(SUBSCRIBER_TYPE* subscriber)
+inline void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(SUBSCRIBER_TYPE* subscriber)
 {
-    return _unsubscribe_from_type_id(subscriber, typeid(REQUEST_TYPE));
+    const std::unique_lock lock { _mutex };
+    return _unsubscribe_from_type_id(_get_subscriber_key(subscriber), type_id_v<REQUEST_TYPE>);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class ... REQUEST_TYPE_LIST, class SUBSCRIBER_TYPE> requires _convertable_to_subscribers_of_<SUBSCRIBER_TYPE, REQUEST_TYPE_LIST...>
-inline bool RequestDispatcher::subscribe(SUBSCRIBER_TYPE* subscriber)
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::subscribe(SUBSCRIBER_TYPE* subscriber)
 {
     bool subscribe_success = true;
 
-    const std::vector<std::type_index> _d_request_type_id_list = { typeid(REQUEST_TYPE_LIST)... };
-
-    for (auto type_id : _d_request_type_id_list) {
-        subscribe_success &= _try_subscribe_to_type_id(subscriber, type_id);
-    }
+    ((subscribe_success &= subscribe<REQUEST_TYPE_LIST>(subscriber)), ...);
 
     return subscribe_success;
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class ... REQUEST_TYPE_LIST, class SUBSCRIBER_TYPE> requires _convertable_to_subscribers_of_<SUBSCRIBER_TYPE, REQUEST_TYPE_LIST...>
-void RequestDispatcher::unsubscribe(SUBSCRIBER_TYPE* subscriber)
+void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::unsubscribe(SUBSCRIBER_TYPE* subscriber)
 {
-    const std::vector<std::type_index> _d_request_type_id_list = { typeid(REQUEST_TYPE_LIST)... };
-
-    for (auto type_id : _d_request_type_id_list) {
-        _unsubscribe_from_type_id(subscriber, type_id);
-    }
+    (unsubscribe<REQUEST_TYPE_LIST>(subscriber), ...);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE> requires _has_void_return_type_<REQUEST_TYPE>
-void RequestDispatcher::dispatch(const REQUEST_TYPE& request) const
+void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const REQUEST_TYPE& request) const
 {
-    const auto request_subscriber_iter = _subscriber_map.find(typeid(request));
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
 
     if (request_subscriber_iter == _subscriber_map.end()) {
         return;
@@ -178,16 +284,17 @@ void RequestDispatcher::dispatch(const REQUEST_TYPE& request) const
     // TODO: Implement dispatch method that dispatches to all appropriate subscribers
     //  and returns a vector holding every response
 
-    const auto& subscriber = request_subscriber_iter->second;
-
-    auto sub_subscriber = dynamic_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber);
-    sub_subscriber->handle_request(request);
+    _handle_request(request_subscriber_iter->second, request);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE> requires _has_expected_return_type_without_string_error_<REQUEST_TYPE>
-inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
+inline auto BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
 {
-    const auto request_subscriber_iter = _subscriber_map.find(typeid(request));
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
 
     if (request_subscriber_iter == _subscriber_map.end()) {
         using ExpectedType = typename REQUEST_TYPE::_RETURN_TYPE_;
@@ -200,16 +307,17 @@ inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> ty
     // TODO: Implement dispatch method that dispatches to all appropriate subscribers
     //  and returns a vector holding every response
 
-    const auto& subscriber = request_subscriber_iter->second;
-
-    auto sub_subscriber = dynamic_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber);
-    return sub_subscriber->handle_request(request);
+    return _handle_request(request_subscriber_iter->second, request);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE> requires _has_pointer_return_type_<REQUEST_TYPE>
-inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
+inline auto BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
 {
-    const auto request_subscriber_iter = _subscriber_map.find(typeid(request));
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
 
     if (request_subscriber_iter == _subscriber_map.end()) {
         return nullptr;
@@ -218,16 +326,17 @@ inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> ty
     // TODO: Implement dispatch method that dispatches to all appropriate subscribers
     //  and returns a vector holding every response
 
-    const auto& subscriber = request_subscriber_iter->second;
-
-    auto sub_subscriber = dynamic_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber);
-    return sub_subscriber->handle_request(request);
+    return _handle_request(request_subscriber_iter->second, request);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE> requires _has_optional_return_type_<REQUEST_TYPE>
-inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
+inline auto BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const REQUEST_TYPE& request) const -> typename REQUEST_TYPE::_RETURN_TYPE_
 {
-    const auto request_subscriber_iter = _subscriber_map.find(typeid(request));
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
 
     if (request_subscriber_iter == _subscriber_map.end()) {
         return std::nullopt;
@@ -236,16 +345,17 @@ inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> ty
     // TODO: Implement dispatch method that dispatches to all appropriate subscribers
     //  and returns a vector holding every response
 
-    const auto& subscriber = request_subscriber_iter->second;
-
-    auto sub_subscriber = dynamic_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber);
-    return sub_subscriber->handle_request(request);
+    return _handle_request(request_subscriber_iter->second, request);
 }
 
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
 template<class REQUEST_TYPE> requires _has_value_return_type_<REQUEST_TYPE>
-inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> std::optional<typename REQUEST_TYPE::_RETURN_TYPE_>
+inline auto BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch(const REQUEST_TYPE& request) const -> std::optional<typename REQUEST_TYPE::_RETURN_TYPE_>
 {
-    const auto request_subscriber_iter = _subscriber_map.find(typeid(request));
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
 
     if (request_subscriber_iter == _subscriber_map.end()) {
         return std::nullopt;
@@ -254,19 +364,80 @@ inline auto RequestDispatcher::dispatch(const REQUEST_TYPE& request) const -> st
     // TODO: Implement dispatch method that dispatches to all appropriate subscribers
     //  and returns a vector holding every response
 
-    const auto& subscriber = request_subscriber_iter->second;
+    return _handle_request(request_subscriber_iter->second, request);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class REQUEST_TYPE> requires _has_request_output_<REQUEST_TYPE>
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::dispatch_into(const REQUEST_TYPE& request, _request_output_t_<REQUEST_TYPE>& output) const
+{
+    const _InstrumentationScope_ dispatch_trace_scope { "dispatch", type_name_v<REQUEST_TYPE>, nullptr };
+
+    const std::shared_lock lock { _mutex };
+    const auto request_subscriber_iter = _subscriber_map.find(type_id_v<REQUEST_TYPE>);
+
+    if (request_subscriber_iter == _subscriber_map.end()) {
+        return false;
+    }
+
+    const auto& subscription = request_subscriber_iter->second;
+
+    const _InstrumentationScope_ handler_trace_scope { "handle_request", type_name_v<REQUEST_TYPE>, subscription.subscriber };
+
+    auto function = reinterpret_cast<_request_into_function_t_<REQUEST_TYPE>>(subscription.handler.into_function);
+    return function(subscription.handler.context, request, output);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class REQUEST_TYPE>
+inline auto BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_handle_request(const _RequestSubscription_& subscription, const REQUEST_TYPE& request) -> typename REQUEST_TYPE::_RETURN_TYPE_
+{
+    const _InstrumentationScope_ handler_trace_scope { "handle_request", type_name_v<REQUEST_TYPE>, subscription.subscriber };
+
+    auto function = reinterpret_cast<_request_handler_function_t_<REQUEST_TYPE>>(subscription.handler.function);
+    return function(subscription.handler.context, request);
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class SUBSCRIBER_TYPE>
+inline const void* BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_subscriber_key(SUBSCRIBER_TYPE* subscriber)
+{
+    if constexpr (std::is_base_of_v<_RequestSubscriberBase_, SUBSCRIBER_TYPE>) {
+        return static_cast<_RequestSubscriberBase_*>(subscriber);
+    }
+
+    else {
+        return static_cast<_static_request_subscriber_base_t_<SUBSCRIBER_TYPE>*>(subscriber);
+    }
+}
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+template<class REQUEST_TYPE, class SUBSCRIBER_TYPE>
+inline _RequestHandler_ BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_get_request_handler(SUBSCRIBER_TYPE* subscriber)
+{
+    if constexpr (std::convertible_to<SUBSCRIBER_TYPE*, _SingleRequestSubscriber_<REQUEST_TYPE>*>) {
+        return static_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber)->_get_single_request_handler();
+    }
 
-    auto sub_subscriber = dynamic_cast<_SingleRequestSubscriber_<REQUEST_TYPE>*>(subscriber);
-    return sub_subscriber->handle_request(request);
+    else {
+        using StaticSubscriberType = _static_request_subscriber_base_t_<SUBSCRIBER_TYPE>;
+        return StaticSubscriberType::template _get_single_request_handler<REQUEST_TYPE>(subscriber);
+    }
 }
 
-inline bool RequestDispatcher::_try_subscribe_to_type_id(_RequestSubscriberBase_* subscriber, std::type_index type_id)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline bool BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_try_subscribe_to_type_id(const void* subscriber, _RequestHandler_ handler, TypeId type_id)
 {
-    auto [_, insert_success] = _subscriber_map.try_emplace(type_id, subscriber);
+    if (_has_type_id_collision_(_subscriber_map, type_id)) {
+        return false;
+    }
+
+    auto [_, insert_success] = _subscriber_map.try_emplace(type_id, _RequestSubscription_ { subscriber, handler });
     return insert_success;
 }
 
-inline void RequestDispatcher::_unsubscribe_from_type_id(_RequestSubscriberBase_* subscriber, std::type_index type_id)
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+inline void BasicRequestDispatcher<THREADING_POLICY, STORAGE_POLICY, INSTRUMENTATION_POLICY>::_unsubscribe_from_type_id(const void* subscriber, TypeId type_id)
 {
     _subscriber_map.erase(type_id);
 }
@@ -24,11 +24,16 @@
 #include "request.h"
 #include "request_concepts.h"
 
+#include "shared/dispatchula_type_info.h"
+
+#include <array>
 #include <concepts>
+#include <cstddef>
 #include <memory>
 #include <optional>
-#include <typeindex>
-#include <vector>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 
 namespace dispatch {
@@ -47,6 +52,24 @@ namespace dispatch {
 template<class ... REQUEST_TYPE_LIST> requires _are_unique_types_<REQUEST_TYPE_LIST...>
 class RequestSubscriber;
 
+/**
+ * An alternative to RequestSubscriber for classes that do not need to handle requests through
+ * a virtual function call.
+ *
+ * The derived class implements one non-virtual `handle_request` function per request type, which
+ * the RequestDispatcher calls directly. The derived class has no vtable pointers or virtual base
+ * classes, and its handlers can be inlined into the dispatcher's call to them. Handler functions
+ * must be public, or the derived class must befriend this class.
+ *
+ * Clients should use this class only to derive from when subscribing to requests.
+ *
+ * @tparam DERIVED_TYPE      - is the derived subscribing class itself
+ * @tparam REQUEST_TYPE_LIST - is a list of all request types the derived subscribing class
+ *                             will ever wish to subscribe to.
+ */
+template<class DERIVED_TYPE, class ... REQUEST_TYPE_LIST> requires _are_unique_types_<REQUEST_TYPE_LIST...>
+class StaticRequestSubscriber;
+
 /**
  * A base class used only by the RequestDispatcher to allow subscribing and unsubscribing
  * to all requests that a subscribing class is subscribed to.
@@ -66,14 +89,108 @@ class _RequestSubscriberBase_;
 template<class REQUEST_TYPE> requires _is_non_value_request_return_type_<typename REQUEST_TYPE::_RETURN_TYPE_>
 class _SingleRequestSubscriber_;
 
+/**
+ * A type erased handler function for a single request type, and the subscriber it is called on.
+ *
+ * `function` is cast back to `_request_handler_function_t_<REQUEST_TYPE>`, and `into_function`
+ * to `_request_into_function_t_<REQUEST_TYPE>`, before being called.
+ *
+ * Clients should not use this struct.
+ */
+struct _RequestHandler_ {
+    void* context;
+    void (*function)();
+    void (*into_function)() = nullptr;
+};
 
-class RequestDispatcher;
+
+/**
+ * Stands in for the output type of requests that have no result, which cannot be dispatched
+ * with `dispatch_into`.
+ *
+ * Clients should not use this struct.
+ */
+struct _NoRequestOutput_ {};
+
+/**
+ * The type a request's result is written to by `dispatch_into`: the value held by the
+ * request's optional, expected or pointer return type.
+ *
+ * Clients should not use this struct.
+ */
+template<class RETURN_TYPE>
+struct _request_output_ {
+    using type = _NoRequestOutput_;
+};
+
+template<class RETURN_TYPE> requires _is_optional_<RETURN_TYPE> || _is_expected_<RETURN_TYPE>
+struct _request_output_<RETURN_TYPE> {
+    using type = typename RETURN_TYPE::value_type;
+};
+
+template<class RETURN_TYPE> requires _is_smart_pointer_<RETURN_TYPE>
+struct _request_output_<RETURN_TYPE> {
+    using type = typename RETURN_TYPE::element_type;
+};
+
+template<class RETURN_TYPE> requires _is_raw_pointer_<RETURN_TYPE>
+struct _request_output_<RETURN_TYPE> {
+    using type = std::remove_cv_t<std::remove_pointer_t<RETURN_TYPE>>;
+};
+
+template<class REQUEST_TYPE>
+using _request_output_t_ = typename _request_output_<typename REQUEST_TYPE::_RETURN_TYPE_>::type;
+
+template<class REQUEST_TYPE>
+concept _has_request_output_ = !std::same_as<_request_output_t_<REQUEST_TYPE>, _NoRequestOutput_>;
+
+
+template<class REQUEST_TYPE>
+using _request_handler_function_t_ = typename REQUEST_TYPE::_RETURN_TYPE_ (*)(void* context, const REQUEST_TYPE& request);
+
+template<class REQUEST_TYPE>
+using _request_into_function_t_ = bool (*)(void* context, const REQUEST_TYPE& request, _request_output_t_<REQUEST_TYPE>& output);
+
+
+/**
+ * Writes the value held by `result` to `output`, returning false if `result` holds no value.
+ * Values owned by `result` are moved, shared or borrowed values are copied.
+ *
+ * Clients should not use this function.
+ */
+template<class RETURN_TYPE, class OUTPUT_TYPE>
+bool _write_request_result_(RETURN_TYPE&& result, OUTPUT_TYPE& output)
+{
+    if (!result) {
+        return false;
+    }
+
+    if constexpr (_is_shared_pointer_<std::remove_cvref_t<RETURN_TYPE>> || _is_raw_pointer_<std::remove_cvref_t<RETURN_TYPE>>) {
+        output = *result;
+    }
+
+    else {
+        output = std::move(*result);
+    }
+
+    return true;
+}
+
+
+template<class THREADING_POLICY, class STORAGE_POLICY, class INSTRUMENTATION_POLICY>
+class BasicRequestDispatcher;
 
 
 class _RequestSubscriberBase_ {
-    friend RequestDispatcher;
+    template<class, class, class>
+    friend class BasicRequestDispatcher;
+
+    virtual std::span<const TypeId> _get_request_type_id_list() = 0;
 
-    virtual const std::vector<std::type_index> &_get_request_type_id_list() = 0;
+    /**
+     * Returns the handler for the request type at `type_index` in `_get_request_type_id_list()`.
+     */
+    virtual _RequestHandler_ _get_request_handler(std::size_t type_index) = 0;
 
 public:
     virtual ~_RequestSubscriberBase_() = default;
@@ -83,12 +200,48 @@ public:
 template<class REQUEST_TYPE> requires _is_non_value_request_return_type_<typename REQUEST_TYPE::_RETURN_TYPE_>
 class _SingleRequestSubscriber_ : virtual public _RequestSubscriberBase_
 {
-    friend RequestDispatcher;
+    template<class, class, class>
+    friend class BasicRequestDispatcher;
 
     using RETURN_TYPE = typename REQUEST_TYPE::_RETURN_TYPE_;
 
     virtual RETURN_TYPE handle_request(const REQUEST_TYPE& dispatch) = 0;
 
+    /**
+     * Handles a request dispatched with `dispatch_into` by writing its result to `output`,
+     * returning false if there is no result. Override this to fill `output` in place, reusing
+     * its storage, instead of returning a result to be moved or copied into it.
+     */
+    virtual bool handle_request_into(const REQUEST_TYPE& dispatch, _request_output_t_<REQUEST_TYPE>& output) {
+        if constexpr (_has_request_output_<REQUEST_TYPE>) {
+            return _write_request_result_(handle_request(dispatch), output);
+        }
+
+        else {
+            return false;
+        }
+    }
+
+    static RETURN_TYPE _handle_request(void* context, const REQUEST_TYPE& request) {
+        return static_cast<_SingleRequestSubscriber_*>(context)->handle_request(request);
+    }
+
+    static bool _handle_request_into(void* context, const REQUEST_TYPE& request, _request_output_t_<REQUEST_TYPE>& output) {
+        return static_cast<_SingleRequestSubscriber_*>(context)->handle_request_into(request, output);
+    }
+
+protected:
+
+    _RequestHandler_ _get_single_request_handler() {
+        if constexpr (_has_request_output_<REQUEST_TYPE>) {
+            return { this, reinterpret_cast<void (*)()>(&_handle_request), reinterpret_cast<void (*)()>(&_handle_request_into) };
+        }
+
+        else {
+            return { this, reinterpret_cast<void (*)()>(&_handle_request) };
+        }
+    }
+
 public:
     virtual ~_SingleRequestSubscriber_() = default;
 };
@@ -97,23 +250,100 @@ public:
 template<class ... REQUEST_TYPE_LIST> requires _are_unique_types_<REQUEST_TYPE_LIST...>
 class RequestSubscriber : public _SingleRequestSubscriber_<REQUEST_TYPE_LIST>...
 {
-    const std::vector<std::type_index>& _get_request_type_id_list() override {
+    std::span<const TypeId> _get_request_type_id_list() override {
         return _request_type_id_list;
     }
 
-    static inline const std::vector<std::type_index> _request_type_id_list = { typeid(REQUEST_TYPE_LIST)... };
+    _RequestHandler_ _get_request_handler(std::size_t type_index) override {
+        const _RequestHandler_ request_handler_list[] = { _SingleRequestSubscriber_<REQUEST_TYPE_LIST>::_get_single_request_handler()... };
+        return request_handler_list[type_index];
+    }
+
+    static constexpr std::array<TypeId, sizeof...(REQUEST_TYPE_LIST)> _request_type_id_list = { type_id_v<REQUEST_TYPE_LIST>... };
 
 public:
     virtual ~RequestSubscriber() = default;
 };
 
 
+template<class DERIVED_TYPE, class ... REQUEST_TYPE_LIST> requires _are_unique_types_<REQUEST_TYPE_LIST...>
+class StaticRequestSubscriber
+{
+    template<class, class, class>
+    friend class BasicRequestDispatcher;
+
+    template<class REQUEST_TYPE>
+    static typename REQUEST_TYPE::_RETURN_TYPE_ _handle_request(void* context, const REQUEST_TYPE& request) {
+        return static_cast<DERIVED_TYPE*>(context)->handle_request(request);
+    }
+
+    /**
+     * Calls the derived class's `handle_request_into(request, output)` if it has one, otherwise
+     * writes the result of `handle_request(request)` to `output`.
+     */
+    template<class REQUEST_TYPE>
+    static bool _handle_request_into(void* context, const REQUEST_TYPE& request, _request_output_t_<REQUEST_TYPE>& output) {
+        auto subscriber = static_cast<DERIVED_TYPE*>(context);
+
+        if constexpr (requires { { subscriber->handle_request_into(request, output) } -> std::convertible_to<bool>; }) {
+            return subscriber->handle_request_into(request, output);
+        }
+
+        else {
+            return _write_request_result_(subscriber->handle_request(request), output);
+        }
+    }
+
+    template<class REQUEST_TYPE>
+    static _RequestHandler_ _get_single_request_handler(DERIVED_TYPE* subscriber) {
+        if constexpr (_has_request_output_<REQUEST_TYPE>) {
+            return { subscriber, reinterpret_cast<void (*)()>(&_handle_request<REQUEST_TYPE>), reinterpret_cast<void (*)()>(&_handle_request_into<REQUEST_TYPE>) };
+        }
+
+        else {
+            return { subscriber, reinterpret_cast<void (*)()>(&_handle_request<REQUEST_TYPE>) };
+        }
+    }
+
+    _RequestHandler_ _get_request_handler(std::size_t type_index) {
+        const _RequestHandler_ request_handler_list[] = { _get_single_request_handler<REQUEST_TYPE_LIST>(static_cast<DERIVED_TYPE*>(this))... };
+        return request_handler_list[type_index];
+    }
+
+    static constexpr std::array<TypeId, sizeof...(REQUEST_TYPE_LIST)> _request_type_id_list = { type_id_v<REQUEST_TYPE_LIST>... };
+};
+
+
+/**
+ * Only declared, to deduce the StaticRequestSubscriber base class of a subscriber type.
+ */
+template<class DERIVED_TYPE, class ... REQUEST_TYPE_LIST>
+StaticRequestSubscriber<DERIVED_TYPE, REQUEST_TYPE_LIST...>* _as_static_request_subscriber_(StaticRequestSubscriber<DERIVED_TYPE, REQUEST_TYPE_LIST...>* subscriber);
+
+template<class REQUEST_TYPE, class DERIVED_TYPE, class ... REQUEST_TYPE_LIST>
+constexpr bool _static_request_subscriber_handles_(StaticRequestSubscriber<DERIVED_TYPE, REQUEST_TYPE_LIST...>*)
+{
+    return (std::is_same_v<REQUEST_TYPE, REQUEST_TYPE_LIST> || ...);
+}
+
+
+template<class SUBSCRIBER_TYPE>
+concept _is_static_request_subscriber_ = requires(SUBSCRIBER_TYPE* subscriber) { _as_static_request_subscriber_(subscriber); };
+
+template<class SUBSCRIBER_TYPE>
+using _static_request_subscriber_base_t_ = std::remove_pointer_t<decltype(_as_static_request_subscriber_(std::declval<SUBSCRIBER_TYPE*>()))>;
+
+template <class SUBSCRIBER_TYPE, class REQUEST_TYPE>
+concept _is_static_subscriber_of_ = _is_static_request_subscriber_<SUBSCRIBER_TYPE>
+                                    && _static_request_subscriber_handles_<REQUEST_TYPE>(static_cast<SUBSCRIBER_TYPE*>(nullptr));
+
 template <class SUBSCRIBER_TYPE, class REQUEST_TYPE>
-concept _convertable_to_subscriber_of_ = std::convertible_to<SUBSCRIBER_TYPE*, _SingleRequestSubscriber_<REQUEST_TYPE>*>;
+concept _convertable_to_subscriber_of_ = std::convertible_to<SUBSCRIBER_TYPE*, _SingleRequestSubscriber_<REQUEST_TYPE>*>
+                                         || _is_static_subscriber_of_<SUBSCRIBER_TYPE, REQUEST_TYPE>;
 
 
 template <class SUBSCRIBER_TYPE, class ... REQUEST_TYPE_LIST>
-concept _convertable_to_subscribers_of_ = (std::convertible_to<SUBSCRIBER_TYPE*, _SingleRequestSubscriber_<REQUEST_TYPE_LIST>*> && ...) && sizeof...(REQUEST_TYPE_LIST) > 1;
+concept _convertable_to_subscribers_of_ = (_convertable_to_subscriber_of_<SUBSCRIBER_TYPE, REQUEST_TYPE_LIST> && ...) && sizeof...(REQUEST_TYPE_LIST) > 1;
 
 
 } // namespace dispatch
@@ -0,0 +1,178 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#pragma once
+
+
+#include "dispatch_tracer.h"
+
+#include <atomic>
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace dispatch {
+
+
+/**
+ * A mutex that does nothing, for dispatchers that are only used from one thread.
+ *
+ * Clients should not use this class.
+ */
+class _NullMutex_ {
+
+public:
+
+    void lock() {}
+    void unlock() {}
+    void lock_shared() {}
+    void unlock_shared() {}
+};
+
+
+/**
+ * A reader/writer lock that a thread may lock shared again while it already holds it shared,
+ * which a dispatcher needs because handlers may dispatch from inside a dispatch.
+ *
+ * Shared locks are taken whenever no exclusive lock is held, even while an exclusive lock is
+ * waiting, so that nested shared locks can never deadlock. Exclusive locks are only taken by
+ * subscription changes, which are expected to be rare.
+ *
+ * Clients should not use this class.
+ */
+class _SharedDispatchMutex_ {
+
+public:
+
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+private:
+
+    static constexpr int EXCLUSIVE_STATE = -1;
+
+    std::atomic<int> _state { 0 };
+};
+
+
+/**
+ * Threading policies decide how a dispatcher guards its subscriptions. Each provides a
+ * `mutex_type` with `lock`, `unlock`, `lock_shared` and `unlock_shared` member functions, and
+ * `is_thread_safe`.
+ *
+ * With `SingleThreaded`, every lock compiles away, and the dispatcher must only be used from
+ * one thread at a time. With `MultiThreaded`, any thread may dispatch while other threads
+ * dispatch, subscribe or unsubscribe. Handlers must not subscribe or unsubscribe while handling
+ * an event or request.
+ */
+struct SingleThreaded {
+    using mutex_type = _NullMutex_;
+    static constexpr bool is_thread_safe = false;
+};
+
+struct MultiThreaded {
+    using mutex_type = _SharedDispatchMutex_;
+    static constexpr bool is_thread_safe = true;
+};
+
+
+/**
+ * Storage policies decide how a dispatcher looks subscriptions up by TypeId. Each provides a
+ * `map_type<KEY_TYPE, VALUE_TYPE>` alias for an allocator aware, node based map, so that
+ * references to its values stay valid as it grows.
+ */
+struct HashStorage {
+    template<class KEY_TYPE, class VALUE_TYPE>
+    using map_type = std::pmr::unordered_map<KEY_TYPE, VALUE_TYPE>;
+};
+
+struct OrderedStorage {
+    template<class KEY_TYPE, class VALUE_TYPE>
+    using map_type = std::pmr::map<KEY_TYPE, VALUE_TYPE>;
+};
+
+
+/**
+ * Instrumentation policies decide what a dispatcher records about each dispatch and handler
+ * call. Each provides a `scope_type` that the dispatcher constructs from a span name, the
+ * dispatched type's name and the handling subscriber (nullptr for dispatches), and destroys
+ * when the span ends.
+ *
+ * `TracingInstrumentation` records spans with the DispatchTracer while it is enabled.
+ * `NoInstrumentation` records nothing, and costs nothing.
+ */
+struct NoInstrumentation {
+    struct scope_type {
+        scope_type(std::string_view, std::string_view, const void*) {}
+    };
+};
+
+struct TracingInstrumentation {
+    using scope_type = _TraceScope_;
+};
+
+
+inline void _SharedDispatchMutex_::lock()
+{
+    auto state = 0;
+
+    while (!_state.compare_exchange_weak(state, EXCLUSIVE_STATE, std::memory_order_acquire, std::memory_order_relaxed)) {
+        if (state != 0) {
+            _state.wait(state, std::memory_order_relaxed);
+        }
+
+        state = 0;
+    }
+}
+
+inline void _SharedDispatchMutex_::unlock()
+{
+    _state.store(0, std::memory_order_release);
+    _state.notify_all();
+}
+
+inline void _SharedDispatchMutex_::lock_shared()
+{
+    auto state = _state.load(std::memory_order_relaxed);
+
+    while (true) {
+        if (state == EXCLUSIVE_STATE) {
+            _state.wait(state, std::memory_order_relaxed);
+            state = _state.load(std::memory_order_relaxed);
+        }
+
+        else if (_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+inline void _SharedDispatchMutex_::unlock_shared()
+{
+    if (_state.fetch_sub(1, std::memory_order_release) == 1) {
+        _state.notify_all();
+    }
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,334 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+
+namespace dispatch {
+
+
+/**
+ * A single begin/end span recorded by the DispatchTracer.
+ *
+ * `name` is either "dispatch", "handle_event" or "handle_request", `type_name` is the
+ * name of the dispatched event or request type and `subscriber` is the address of the
+ * handling subscriber (nullptr for "dispatch" spans).
+ */
+struct TraceSpan {
+    std::string_view name;
+    std::string_view type_name;
+    const void* subscriber;
+    std::uint64_t begin_ns;
+    std::uint64_t end_ns;
+    std::uint32_t thread_id;
+};
+
+/**
+ * Records a span for every dispatch and every handler call made by the EventDispatcher
+ * and the RequestDispatcher while enabled.
+ *
+ * Spans are written to a fixed size ring buffer owned by the recording thread, so
+ * recording never locks or allocates after a thread's first span. When a thread records
+ * more than `BUFFER_CAPACITY` spans, the oldest spans are overwritten. A thread's buffer
+ * is kept after the thread exits, until its spans are next collected or cleared.
+ *
+ * `collect` and `write_chrome_trace` read every thread's buffer, they should only be
+ * called while no other thread is dispatching.
+ *
+ * Refer to the "Tracing" section of `README.md` for example usage.
+ */
+class DispatchTracer {
+
+public:
+
+    static constexpr std::size_t BUFFER_CAPACITY = 1 << 14;
+
+    static void enable();
+    static void disable();
+    static bool is_enabled();
+
+    /**
+     * Discards all recorded spans from all threads.
+     */
+    static void clear();
+
+    /**
+     * Returns all recorded spans from all threads, ordered by begin time.
+     */
+    static std::vector<TraceSpan> collect();
+
+    /**
+     * Writes all recorded spans to `path` in the Chrome trace event JSON format, which can
+     * be opened by `chrome://tracing` or https://ui.perfetto.dev.
+     */
+    static bool write_chrome_trace(const std::filesystem::path& path);
+
+private:
+
+    friend class _TraceScope_;
+
+    class _TraceBuffer_;
+
+    static _TraceBuffer_& _get_thread_buffer();
+    static std::uint64_t _now_ns();
+
+    static inline std::atomic<bool> _enabled { false };
+
+    static inline std::mutex _buffer_list_mutex {};
+    static inline std::vector<std::shared_ptr<_TraceBuffer_>> _buffer_list {};
+    static inline std::uint32_t _next_thread_id = 1;
+};
+
+
+/**
+ * Records a single span from construction to destruction while the DispatchTracer is enabled.
+ *
+ * Clients should not use this class.
+ */
+class _TraceScope_ {
+
+public:
+
+    _TraceScope_(std::string_view name, std::string_view type_name, const void* subscriber);
+    ~_TraceScope_();
+
+    _TraceScope_(const _TraceScope_&) = delete;
+    _TraceScope_& operator=(const _TraceScope_&) = delete;
+
+private:
+
+    std::string_view _name;
+    std::string_view _type_name;
+    const void* _subscriber;
+    std::uint64_t _begin_ns = 0;
+    bool _active;
+};
+
+
+class DispatchTracer::_TraceBuffer_ {
+
+public:
+
+    explicit _TraceBuffer_(std::uint32_t thread_id) : _thread_id(thread_id) {}
+
+    void push(const TraceSpan& span)
+    {
+        const auto write_count = _write_count.load(std::memory_order_relaxed);
+        _span_list[write_count % BUFFER_CAPACITY] = span;
+        _write_count.store(write_count + 1, std::memory_order_release);
+    }
+
+    void copy_to(std::vector<TraceSpan>& span_list) const
+    {
+        const auto write_count = _write_count.load(std::memory_order_acquire);
+        const auto read_count = std::min<std::uint64_t>(write_count, BUFFER_CAPACITY);
+
+        for (auto index = write_count - read_count; index < write_count; ++index) {
+            span_list.push_back(_span_list[index % BUFFER_CAPACITY]);
+        }
+    }
+
+    void clear()
+    {
+        _write_count.store(0, std::memory_order_release);
+    }
+
+    void retire()
+    {
+        _retired.store(true, std::memory_order_release);
+    }
+
+    bool is_retired() const
+    {
+        return _retired.load(std::memory_order_acquire);
+    }
+
+    std::uint32_t thread_id() const
+    {
+        return _thread_id;
+    }
+
+private:
+
+    std::array<TraceSpan, BUFFER_CAPACITY> _span_list {};
+    std::atomic<std::uint64_t> _write_count { 0 };
+    std::atomic<bool> _retired { false };
+    std::uint32_t _thread_id;
+};
+
+
+inline void DispatchTracer::enable()
+{
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+inline void DispatchTracer::disable()
+{
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+inline bool DispatchTracer::is_enabled()
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline void DispatchTracer::clear()
+{
+    std::lock_guard lock { _buffer_list_mutex };
+
+    for (auto& buffer : _buffer_list) {
+        buffer->clear();
+    }
+
+    std::erase_if(_buffer_list, [](const std::shared_ptr<_TraceBuffer_>& buffer) {
+        return buffer->is_retired();
+    });
+}
+
+inline std::vector<TraceSpan> DispatchTracer::collect()
+{
+    std::vector<TraceSpan> span_list {};
+
+    {
+        std::lock_guard lock { _buffer_list_mutex };
+
+        std::erase_if(_buffer_list, [&span_list](const std::shared_ptr<_TraceBuffer_>& buffer) {
+            // Checked before copying, so a buffer retired meanwhile is kept until its last spans are collected
+            const bool is_retired = buffer->is_retired();
+            buffer->copy_to(span_list);
+
+            return is_retired;
+        });
+    }
+
+    std::stable_sort(span_list.begin(), span_list.end(), [](const TraceSpan& lhs, const TraceSpan& rhs) {
+        return lhs.begin_ns < rhs.begin_ns;
+    });
+
+    return span_list;
+}
+
+inline bool DispatchTracer::write_chrome_trace(const std::filesystem::path& path)
+{
+    std::ofstream file { path, std::ios::trunc };
+
+    if (!file) {
+        return false;
+    }
+
+    const auto write_escaped = [&file](std::string_view text) {
+        for (auto character : text) {
+            if (character == '"' || character == '\\') {
+                file << '\\';
+            }
+            file << character;
+        }
+    };
+
+    const auto span_list = collect();
+
+    file << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+    for (std::size_t index = 0; index < span_list.size(); ++index) {
+        const auto& span = span_list[index];
+
+        file << (index == 0 ? "\n" : ",\n");
+        file << R"({"name":")" << span.name << ' ';
+        write_escaped(span.type_name);
+        file << R"(","cat":"dispatchula","ph":"X","pid":1,"tid":)" << span.thread_id;
+        file << R"(,"ts":)" << span.begin_ns / 1000 << '.' << std::setfill('0') << std::setw(3) << span.begin_ns % 1000;
+        file << R"(,"dur":)" << (span.end_ns - span.begin_ns) / 1000 << '.' << std::setfill('0') << std::setw(3) << (span.end_ns - span.begin_ns) % 1000;
+        file << R"(,"args":{"type":")";
+        write_escaped(span.type_name);
+        file << R"(","subscriber":")" << span.subscriber << R"("}})";
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+inline DispatchTracer::_TraceBuffer_& DispatchTracer::_get_thread_buffer()
+{
+    // Retires the thread's buffer when the thread exits, so `collect` or `clear` can drop it
+    struct ThreadBufferOwner {
+        std::shared_ptr<_TraceBuffer_> buffer;
+
+        ~ThreadBufferOwner()
+        {
+            buffer->retire();
+        }
+    };
+
+    thread_local const ThreadBufferOwner thread_buffer_owner { [] {
+        std::lock_guard lock { _buffer_list_mutex };
+
+        auto buffer = std::make_shared<_TraceBuffer_>(_next_thread_id++);
+        _buffer_list.push_back(buffer);
+
+        return buffer;
+    }() };
+
+    return *thread_buffer_owner.buffer;
+}
+
+inline std::uint64_t DispatchTracer::_now_ns()
+{
+    const auto time_since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_since_epoch).count());
+}
+
+
+inline _TraceScope_::_TraceScope_(std::string_view name, std::string_view type_name, const void* subscriber)
+    : _name(name)
+    , _type_name(type_name)
+    , _subscriber(subscriber)
+    , _active(DispatchTracer::is_enabled())
+{
+    if (_active) {
+        _begin_ns = DispatchTracer::_now_ns();
+    }
+}
+
+inline _TraceScope_::~_TraceScope_()
+{
+    if (_active) {
+        const auto end_ns = DispatchTracer::_now_ns();
+        auto& buffer = DispatchTracer::_get_thread_buffer();
+        buffer.push({ _name, _type_name, _subscriber, _begin_ns, end_ns, buffer.thread_id() });
+    }
+}
+
+
+} // namespace dispatch
@@ -0,0 +1,195 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2022 Peter Burgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+#pragma once
+
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string_view>
+
+
+namespace dispatch {
+
+
+/**
+ * Returns the compiler generated signature of this function, which embeds the name of `T`.
+ *
+ * Clients should not use this function.
+ */
+template<class T>
+constexpr const char* _pretty_function_()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+/**
+ * Extracts the name of `T` from `_pretty_function_<T>()` at compile time.
+ *
+ * Clients should not use this function, use `type_name_v` instead.
+ */
+template<class T>
+constexpr std::string_view _type_name_()
+{
+    constexpr std::string_view pretty_function = _pretty_function_<T>();
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    constexpr std::string_view prefix = "_pretty_function_<";
+    constexpr std::string_view suffix = ">(void)";
+    constexpr auto name_begin = pretty_function.find(prefix) + prefix.size();
+    constexpr auto name_end = pretty_function.rfind(suffix);
+#else
+    constexpr std::string_view prefix = "T = ";
+    constexpr auto name_begin = pretty_function.find(prefix) + prefix.size();
+    constexpr auto name_end = pretty_function.rfind(']');
+#endif
+
+    return pretty_function.substr(name_begin, name_end - name_begin);
+}
+
+/**
+ * The human readable name of `T`, available at compile time and without RTTI.
+ *
+ * The spelling is compiler specific (e.g. `Foo<int, Bar>` vs `Foo<int,Bar>`), but is
+ * stable across builds made with the same compiler.
+ */
+template<class T>
+inline constexpr std::string_view type_name_v = _type_name_<T>();
+
+
+/**
+ * A variable with one address per type, which identifies the type within a process.
+ *
+ * Clients should not use this variable.
+ */
+template<class T>
+inline constexpr char _type_id_tag_v = 0;
+
+
+/**
+ * Identifies a type without RTTI, by the address of its `_type_id_tag_v` within a process and
+ * by a 64-bit FNV-1a hash of its `type_name_v` outside of it.
+ *
+ * Two TypeIds only compare equal if their tags are the same object, so neither a hash collision
+ * nor two types with the same name (e.g. in anonymous namespaces of different translation units)
+ * can cause one type to be mistaken for another. The hash is stable across builds and processes
+ * made with the same compiler, so it is what identifies types shared between processes. Like
+ * type names, it can collide, so such types must be checked with `_has_type_id_collision_` or
+ * registered with an `EventTypeRegistry` before use.
+ */
+struct TypeId {
+    std::uint64_t hash;
+    std::string_view name;
+    const void* tag;
+
+    friend constexpr bool operator==(const TypeId& lhs, const TypeId& rhs)
+    {
+        return lhs.tag == rhs.tag;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(const TypeId& lhs, const TypeId& rhs)
+    {
+        if (lhs.hash != rhs.hash || lhs.tag == rhs.tag) {
+            return lhs.hash <=> rhs.hash;
+        }
+
+        return std::compare_three_way {}(lhs.tag, rhs.tag);
+    }
+};
+
+constexpr std::uint64_t _fnv1a_hash_(std::string_view text)
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+
+    for (auto character : text) {
+        hash ^= static_cast<std::uint8_t>(character);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+template<class T>
+inline constexpr TypeId type_id_v { _fnv1a_hash_(type_name_v<T>), type_name_v<T>, &_type_id_tag_v<T> };
+
+
+/**
+ * Returns true if `type_id_map` has a key with the same hash as `type_id` that belongs to
+ * a different type.
+ *
+ * Clients should not use this function.
+ *
+ * @tparam TYPE_ID_MAP_TYPE - is an ordered or unordered map keyed by TypeId
+ */
+template<class TYPE_ID_MAP_TYPE>
+bool _has_type_id_collision_(const TYPE_ID_MAP_TYPE& type_id_map, const TypeId& type_id)
+{
+    const auto collides = [&type_id](const TypeId& key) {
+        return key.hash == type_id.hash && key != type_id;
+    };
+
+    if constexpr (requires { type_id_map.bucket(type_id); }) {
+        const auto bucket = type_id_map.bucket(type_id);
+
+        for (auto type_id_iter = type_id_map.begin(bucket); type_id_iter != type_id_map.end(bucket); ++type_id_iter) {
+            if (collides(type_id_iter->first)) {
+                return true;
+            }
+        }
+    }
+
+    else {
+        // Keys are ordered by hash first, so every key sharing the hash is next to `type_id`
+        const auto lower_bound_iter = type_id_map.lower_bound(type_id);
+
+        for (auto type_id_iter = lower_bound_iter; type_id_iter != type_id_map.end() && type_id_iter->first.hash == type_id.hash; ++type_id_iter) {
+            if (collides(type_id_iter->first)) {
+                return true;
+            }
+        }
+
+        for (auto type_id_iter = lower_bound_iter; type_id_iter != type_id_map.begin() && std::prev(type_id_iter)->first.hash == type_id.hash; --type_id_iter) {
+            if (collides(std::prev(type_id_iter)->first)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+} // namespace dispatch
+
+
+template<>
+struct std::hash<dispatch::TypeId> {
+    std::size_t operator()(const dispatch::TypeId& type_id) const noexcept
+    {
+        return static_cast<std::size_t>(type_id.hash);
+    }
+};
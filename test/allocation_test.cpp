@@ -0,0 +1,383 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/deferred_event_queue.h"
+#include "event/event_dispatcher.h"
+#include "event/event_queue.h"
+#include "event/event_subscriber.h"
+#include "event/event_tap.h"
+#include "request/object_pool.h"
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+
+
+/// Global allocation counting
+///
+/// Every allocation made by this test program goes through these replacements, so each test
+/// can check that the code it measures does not allocate once it has warmed up.
+
+namespace {
+
+std::atomic<std::size_t> allocation_count = 0;
+
+void* count_allocation(std::size_t size, std::size_t alignment)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    void* memory = alignment <= alignof(std::max_align_t)
+                   ? std::malloc(size == 0 ? 1 : size)
+                   : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+/**
+ * Returns the number of allocations made by `function`.
+ */
+template<class FUNCTION_TYPE>
+std::size_t count_allocations(FUNCTION_TYPE&& function)
+{
+    const auto begin_count = allocation_count.load(std::memory_order_relaxed);
+    function();
+    return allocation_count.load(std::memory_order_relaxed) - begin_count;
+}
+
+constexpr int REPEAT_COUNT = 1000;
+
+} // namespace
+
+void* operator new(std::size_t size) { return count_allocation(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return count_allocation(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return count_allocation(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return count_allocation(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+
+/// Test events and requests
+
+struct PositionEvent {
+    int x;
+    int y;
+};
+
+struct FrameEvent {
+    int frame;
+};
+
+struct NotifyRequest : public dispatch::Request<> {};
+struct CountRequest : public dispatch::Request<int> {};
+struct MaybeCountRequest : public dispatch::Request<std::optional<int>> {};
+struct CheckedCountRequest : public dispatch::Request<std::expected<int, int>> {};
+struct CounterRequest : public dispatch::Request<int*> {};
+struct SharedCounterRequest : public dispatch::Request<std::shared_ptr<int>> {};
+struct PooledCounterRequest : public dispatch::Request<dispatch::PooledPtr<int>> {};
+
+
+/// Test subscribers
+
+class PositionSubscriber : public dispatch::EventSubscriber<PositionEvent, FrameEvent>
+{
+public:
+
+    void handle_event(const PositionEvent& event) override
+    {
+        x_total += event.x;
+    }
+
+    void handle_event(const FrameEvent& event) override
+    {
+        frame = event.frame;
+    }
+
+    int x_total = 0;
+    int frame = 0;
+};
+
+class StaticPositionSubscriber : public dispatch::StaticEventSubscriber<StaticPositionSubscriber, PositionEvent>
+{
+public:
+
+    void handle_event(const PositionEvent& event)
+    {
+        y_total += event.y;
+    }
+
+    int y_total = 0;
+};
+
+class CounterSubscriber : public dispatch::RequestSubscriber<NotifyRequest, CountRequest, MaybeCountRequest, CheckedCountRequest, CounterRequest>
+{
+public:
+
+    void handle_request(const NotifyRequest& request) override
+    {
+        ++count;
+    }
+
+    std::optional<int> handle_request(const CountRequest& request) override
+    {
+        return count;
+    }
+
+    std::optional<int> handle_request(const MaybeCountRequest& request) override
+    {
+        return count;
+    }
+
+    std::expected<int, int> handle_request(const CheckedCountRequest& request) override
+    {
+        return count;
+    }
+
+    int* handle_request(const CounterRequest& request) override
+    {
+        return &count;
+    }
+
+    int count = 0;
+};
+
+class StaticCounterSubscriber : public dispatch::StaticRequestSubscriber<StaticCounterSubscriber, SharedCounterRequest, PooledCounterRequest>
+{
+public:
+
+    std::shared_ptr<int> handle_request(const SharedCounterRequest& request)
+    {
+        return counter;
+    }
+
+    dispatch::PooledPtr<int> handle_request(const PooledCounterRequest& request)
+    {
+        return counter_pool.make_unique(*counter);
+    }
+
+    std::shared_ptr<int> counter = std::make_shared<int>(7);
+    dispatch::ObjectPool<int> counter_pool { 4 };
+};
+
+
+/// EventDispatcher tests
+
+TEST_CASE("Test event dispatch does not allocate")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    PositionSubscriber subscriber;
+    StaticPositionSubscriber static_subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.subscribe(&static_subscriber);
+
+    // Each type's dispatch plan is built by its first dispatch
+    event_dispatcher.dispatch(PositionEvent { 0, 0 });
+    event_dispatcher.dispatch(FrameEvent { 0 });
+
+    const std::array<PositionEvent, 4> event_list { PositionEvent { 1, 1 }, PositionEvent { 2, 2 }, PositionEvent { 3, 3 }, PositionEvent { 4, 4 } };
+
+    const auto dispatch_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            event_dispatcher.dispatch(PositionEvent { 1, 2 });
+            event_dispatcher.dispatch_emplace<PositionEvent>(1, 2);
+            event_dispatcher.dispatch_lazy<PositionEvent>([] { return PositionEvent { 1, 2 }; });
+            event_dispatcher.dispatch_batch<PositionEvent>(event_list);
+            event_dispatcher.dispatch(FrameEvent { index });
+        }
+    });
+
+    REQUIRE(dispatch_allocation_count == 0);
+    REQUIRE(subscriber.x_total == REPEAT_COUNT * 13);
+    REQUIRE(static_subscriber.y_total == REPEAT_COUNT * 16);
+}
+
+TEST_CASE("Test event dispatch with sticky events, taps, gates and pipelines does not allocate")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTapBuffer tap_buffer { 16, sizeof(PositionEvent) };
+    PositionSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_sticky<PositionEvent>();
+    event_dispatcher.add_tap(&tap_buffer);
+    event_dispatcher.set_delivery_gate<FrameEvent>(&subscriber, DeliveryGate::debounced(std::chrono::nanoseconds::zero()));
+    std::move(event_dispatcher.on<PositionEvent>().map([](const PositionEvent& event) { return FrameEvent { event.x }; })).to<FrameEvent>();
+
+    event_dispatcher.dispatch(PositionEvent { 0, 0 });
+
+    const auto dispatch_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            event_dispatcher.dispatch(PositionEvent { index, 0 });
+            event_dispatcher.flush_debounced();
+        }
+    });
+
+    REQUIRE(dispatch_allocation_count == 0);
+    REQUIRE(subscriber.frame == REPEAT_COUNT - 1);
+}
+
+TEST_CASE("Test event subscribe and unsubscribe do not allocate once subscriber lists have grown")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    PositionSubscriber subscriber;
+    StaticPositionSubscriber static_subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.subscribe(&static_subscriber);
+    event_dispatcher.unsubscribe(&subscriber);
+    event_dispatcher.unsubscribe(&static_subscriber);
+
+    const auto subscribe_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            event_dispatcher.subscribe(&subscriber);
+            event_dispatcher.subscribe(&static_subscriber);
+            event_dispatcher.unsubscribe(&subscriber);
+            event_dispatcher.unsubscribe(&static_subscriber);
+        }
+    });
+
+    REQUIRE(subscribe_allocation_count == 0);
+}
+
+
+/// Queued event tests
+
+TEST_CASE("Test queued event dispatch does not allocate once queues have grown")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventQueue<PositionEvent> event_queue { 8, OverflowPolicy::DROP_NEWEST };
+    DeferredEventQueue deferred_event_queue { event_dispatcher };
+    PositionSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    // Both of the deferred queue's buffers grow on their first use
+    for (int round = 0; round < 2; ++round) {
+        deferred_event_queue.defer(PositionEvent { 1, 0 });
+        deferred_event_queue.defer(PositionEvent { 1, 0 });
+        deferred_event_queue.dispatch_deferred();
+    }
+
+    const auto queue_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            event_queue.post(PositionEvent { 1, 0 });
+            event_queue.dispatch_queued(event_dispatcher);
+
+            deferred_event_queue.defer(PositionEvent { 1, 0 });
+            deferred_event_queue.defer_emplace<PositionEvent>(1, 0);
+            deferred_event_queue.dispatch_deferred();
+        }
+    });
+
+    REQUIRE(queue_allocation_count == 0);
+    REQUIRE(subscriber.x_total == 4 + REPEAT_COUNT * 3);
+}
+
+
+/// RequestDispatcher tests
+
+TEST_CASE("Test request dispatch does not allocate for any return type")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    CounterSubscriber subscriber;
+    StaticCounterSubscriber static_subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+    request_dispatcher.subscribe(&static_subscriber);
+
+    int count_total = 0;
+    int output = 0;
+
+    const auto dispatch_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            request_dispatcher.dispatch(NotifyRequest {});
+            count_total += request_dispatcher.dispatch(CountRequest {}).value_or(0);
+            count_total += request_dispatcher.dispatch(MaybeCountRequest {}).value_or(0);
+            count_total += request_dispatcher.dispatch(CheckedCountRequest {}).value_or(0);
+            count_total += *request_dispatcher.dispatch(CounterRequest {});
+            count_total += *request_dispatcher.dispatch(SharedCounterRequest {});
+            count_total += *request_dispatcher.dispatch(PooledCounterRequest {});
+            request_dispatcher.dispatch_into(CountRequest {}, output);
+        }
+    });
+
+    REQUIRE(dispatch_allocation_count == 0);
+    REQUIRE(static_subscriber.counter_pool.get_fallback_count() == 0);
+    REQUIRE(count_total > 0);
+    REQUIRE(output == REPEAT_COUNT);
+}
+
+TEST_CASE("Test request subscribe and unsubscribe do not allocate from a pooled memory resource")
+{
+    using namespace dispatch;
+
+    std::pmr::unsynchronized_pool_resource memory_resource;
+    RequestDispatcher request_dispatcher { &memory_resource };
+    CounterSubscriber subscriber;
+    StaticCounterSubscriber static_subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+    request_dispatcher.subscribe(&static_subscriber);
+    request_dispatcher.unsubscribe(&subscriber);
+    request_dispatcher.unsubscribe(&static_subscriber);
+
+    const auto subscribe_allocation_count = count_allocations([&] {
+        for (int index = 0; index < REPEAT_COUNT; ++index) {
+            request_dispatcher.subscribe(&subscriber);
+            request_dispatcher.subscribe<CountRequest, MaybeCountRequest>(&subscriber);
+            request_dispatcher.subscribe(&static_subscriber);
+            request_dispatcher.unsubscribe(&subscriber);
+            request_dispatcher.unsubscribe(&static_subscriber);
+        }
+    });
+
+    REQUIRE(subscribe_allocation_count == 0);
+}
@@ -0,0 +1,281 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "async/bounded_queue.h"
+#include "async/strand.h"
+#include "async/thread_pool.h"
+#include "event/event_dispatcher.h"
+#include "event/event_queue.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+/// Test events
+
+struct PriceEvent {
+    int price;
+};
+
+
+/// Test subscribers
+
+class PriceSubscriber : public dispatch::EventSubscriber<PriceEvent>
+{
+public:
+
+    void handle_event(const PriceEvent& event) override
+    {
+        price_list.push_back(event.price);
+    }
+
+    std::vector<int> price_list {};
+};
+
+
+/// Test helpers
+
+std::vector<int> pop_all(dispatch::BoundedQueue<int>& queue)
+{
+    std::vector<int> item_list;
+
+    while (const auto item = queue.try_pop()) {
+        item_list.push_back(*item);
+    }
+
+    return item_list;
+}
+
+
+/// BoundedQueue tests
+
+TEST_CASE("Test BoundedQueue pops items in the order they were pushed")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 4, OverflowPolicy::DROP_NEWEST };
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    REQUIRE(queue.get_depth() == 3);
+    REQUIRE(pop_all(queue) == std::vector<int> { 1, 2, 3 });
+    REQUIRE(queue.try_pop().has_value() == false);
+}
+
+TEST_CASE("Test BoundedQueue discards pushed item when full under DROP_NEWEST")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 2, OverflowPolicy::DROP_NEWEST };
+
+    REQUIRE(queue.push(1) == true);
+    REQUIRE(queue.push(2) == true);
+    REQUIRE(queue.push(3) == false);
+
+    const auto metrics = queue.get_metrics();
+
+    REQUIRE(metrics.depth == 2);
+    REQUIRE(metrics.pushed_count == 3);
+    REQUIRE(metrics.dropped_count == 1);
+    REQUIRE(pop_all(queue) == std::vector<int> { 1, 2 });
+}
+
+TEST_CASE("Test BoundedQueue discards oldest item when full under DROP_OLDEST")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 2, OverflowPolicy::DROP_OLDEST };
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    REQUIRE(queue.get_metrics().dropped_count == 1);
+    REQUIRE(pop_all(queue) == std::vector<int> { 2, 3 });
+}
+
+TEST_CASE("Test BoundedQueue replaces newest item when full under CONFLATE")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 2, OverflowPolicy::CONFLATE };
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    queue.push(4);
+
+    const auto metrics = queue.get_metrics();
+
+    REQUIRE(metrics.dropped_count == 0);
+    REQUIRE(metrics.conflated_count == 2);
+    REQUIRE(pop_all(queue) == std::vector<int> { 1, 4 });
+}
+
+TEST_CASE("Test BoundedQueue blocks producer when full under BLOCK until an item is popped")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 1, OverflowPolicy::BLOCK };
+    std::atomic<bool> second_push_done = false;
+
+    queue.push(1);
+
+    std::jthread producer_thread([&] {
+        queue.push(2);
+        second_push_done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    REQUIRE(second_push_done == false);
+    REQUIRE(queue.try_pop() == 1);
+
+    producer_thread.join();
+
+    REQUIRE(second_push_done == true);
+    REQUIRE(queue.try_pop() == 2);
+    REQUIRE(queue.get_metrics().dropped_count == 0);
+}
+
+TEST_CASE("Test BoundedQueue high water mark records greatest depth")
+{
+    using namespace dispatch;
+
+    BoundedQueue<int> queue { 8, OverflowPolicy::DROP_NEWEST };
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    pop_all(queue);
+    queue.push(4);
+
+    const auto metrics = queue.get_metrics();
+
+    REQUIRE(metrics.depth == 1);
+    REQUIRE(metrics.capacity == 8);
+    REQUIRE(metrics.high_water_mark == 3);
+}
+
+
+/// EventQueue and Strand mailbox tests
+
+TEST_CASE("Test EventQueue dispatches queued events oldest first")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventQueue<PriceEvent> event_queue { 16, OverflowPolicy::DROP_NEWEST };
+    PriceSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    event_queue.post(PriceEvent { 1 });
+    event_queue.post(PriceEvent { 2 });
+    event_queue.post(PriceEvent { 3 });
+
+    REQUIRE(subscriber.price_list.empty());
+    REQUIRE(event_queue.dispatch_queued(event_dispatcher, 2) == 2);
+    REQUIRE(subscriber.price_list == std::vector<int> { 1, 2 });
+    REQUIRE(event_queue.dispatch_queued(event_dispatcher) == 1);
+    REQUIRE(subscriber.price_list == std::vector<int> { 1, 2, 3 });
+}
+
+TEST_CASE("Test EventQueue dispatches queued events with a multi threaded dispatcher")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation> event_dispatcher;
+    EventQueue<PriceEvent> event_queue { 16, OverflowPolicy::DROP_NEWEST };
+    PriceSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    std::thread posting_thread([&event_queue] {
+        for (int price = 1; price <= 3; ++price) {
+            event_queue.post(PriceEvent { price });
+        }
+    });
+
+    posting_thread.join();
+
+    REQUIRE(event_queue.dispatch_queued(event_dispatcher) == 3);
+    REQUIRE(subscriber.price_list == std::vector<int> { 1, 2, 3 });
+}
+
+TEST_CASE("Test conflating EventQueue of capacity one keeps only the latest event")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventQueue<PriceEvent> event_queue { 1, OverflowPolicy::CONFLATE };
+    PriceSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    for (int price = 0; price < 100; ++price) {
+        event_queue.post(PriceEvent { price });
+    }
+
+    event_queue.dispatch_queued(event_dispatcher);
+
+    REQUIRE(subscriber.price_list == std::vector<int> { 99 });
+    REQUIRE(event_queue.get_metrics().conflated_count == 99);
+}
+
+TEST_CASE("Test Strand mailbox drops tasks posted while full under DROP_NEWEST")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool, 2, OverflowPolicy::DROP_NEWEST };
+
+    std::atomic<bool> release = false;
+    std::atomic<int> task_count = 0;
+
+    // Occupies the strand, so the next posts stay in its mailbox
+    strand.post([&] {
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (strand.get_backlog() != 0) {
+        std::this_thread::yield();
+    }
+
+    REQUIRE(strand.post([&] { ++task_count; }) == true);
+    REQUIRE(strand.post([&] { ++task_count; }) == true);
+    REQUIRE(strand.post([&] { ++task_count; }) == false);
+
+    release = true;
+    strand.wait_idle();
+
+    REQUIRE(task_count == 2);
+    REQUIRE(strand.get_mailbox_metrics().dropped_count == 1);
+}
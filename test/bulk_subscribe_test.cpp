@@ -0,0 +1,184 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <span>
+#include <vector>
+
+
+/// Test events
+
+struct SpawnedEvent {
+    int frame;
+};
+
+struct TickEvent {};
+
+
+/// Test subscribers
+
+class Entity : public dispatch::EventSubscriber<SpawnedEvent, TickEvent>
+{
+public:
+
+    explicit Entity(int entity_id, std::vector<int>& tick_log) : id(entity_id), log(tick_log) {}
+
+    void handle_event(const SpawnedEvent& event) override
+    {
+        spawned_frame = event.frame;
+    }
+
+    void handle_event(const TickEvent&) override
+    {
+        log.push_back(id);
+    }
+
+    int id;
+    int spawned_frame = -1;
+    std::vector<int>& log;
+};
+
+class StaticEntity : public dispatch::StaticEventSubscriber<StaticEntity, TickEvent>
+{
+public:
+
+    explicit StaticEntity(int entity_id, std::vector<int>& tick_log) : id(entity_id), log(tick_log) {}
+
+    void handle_event(const TickEvent&)
+    {
+        log.push_back(id);
+    }
+
+    int id;
+    std::vector<int>& log;
+};
+
+
+/// subscribe_all tests
+
+TEST_CASE("Test subscribe_all subscribes every subscriber in order")
+{
+    using namespace dispatch;
+
+    std::vector<int> log;
+    EventDispatcher event_dispatcher;
+    Entity first_entity { 1, log };
+    Entity second_entity { 2, log };
+    Entity third_entity { 3, log };
+
+    event_dispatcher.subscribe(&first_entity);
+
+    const std::array<Entity*, 2> entity_list { &second_entity, &third_entity };
+
+    REQUIRE(event_dispatcher.subscribe_all<Entity>(entity_list) == true);
+
+    event_dispatcher.dispatch(TickEvent {});
+    event_dispatcher.dispatch(SpawnedEvent { 7 });
+
+    REQUIRE(log == std::vector<int> { 1, 2, 3 });
+    REQUIRE(third_entity.spawned_frame == 7);
+}
+
+TEST_CASE("Test subscribe_all subscribes static subscribers")
+{
+    using namespace dispatch;
+
+    std::vector<int> log;
+    EventDispatcher event_dispatcher;
+    StaticEntity first_entity { 1, log };
+    StaticEntity second_entity { 2, log };
+
+    const std::array<StaticEntity*, 2> entity_list { &first_entity, &second_entity };
+
+    REQUIRE(event_dispatcher.subscribe_all<StaticEntity>(entity_list) == true);
+
+    event_dispatcher.dispatch(TickEvent {});
+
+    REQUIRE(log == std::vector<int> { 1, 2 });
+}
+
+TEST_CASE("Test subscribe_all delivers sticky events to every subscriber")
+{
+    using namespace dispatch;
+
+    std::vector<int> log;
+    EventDispatcher event_dispatcher;
+    Entity first_entity { 1, log };
+    Entity second_entity { 2, log };
+
+    event_dispatcher.set_sticky<SpawnedEvent>();
+    event_dispatcher.dispatch(SpawnedEvent { 3 });
+
+    const std::array<Entity*, 2> entity_list { &first_entity, &second_entity };
+    event_dispatcher.subscribe_all<Entity>(entity_list);
+
+    REQUIRE(first_entity.spawned_frame == 3);
+    REQUIRE(second_entity.spawned_frame == 3);
+}
+
+
+/// unsubscribe_all tests
+
+TEST_CASE("Test unsubscribe_all unsubscribes only the given subscribers and keeps the rest in order")
+{
+    using namespace dispatch;
+
+    std::vector<int> log;
+    std::vector<Entity> entity_list;
+    std::vector<Entity*> subscribing_list;
+    std::vector<Entity*> unsubscribing_list;
+
+    entity_list.reserve(1000);
+
+    for (int id = 0; id < 1000; ++id) {
+        entity_list.emplace_back(id, log);
+    }
+
+    for (auto& entity : entity_list) {
+        subscribing_list.push_back(&entity);
+
+        if (entity.id % 3 != 0) {
+            unsubscribing_list.push_back(&entity);
+        }
+    }
+
+    EventDispatcher event_dispatcher;
+
+    event_dispatcher.subscribe_all<Entity>(subscribing_list);
+    event_dispatcher.unsubscribe_all<Entity>(unsubscribing_list);
+    event_dispatcher.dispatch(TickEvent {});
+
+    std::vector<int> expected_log;
+
+    for (int id = 0; id < 1000; id += 3) {
+        expected_log.push_back(id);
+    }
+
+    REQUIRE(log == expected_log);
+
+    event_dispatcher.unsubscribe_all<Entity>(subscribing_list);
+
+    REQUIRE(event_dispatcher.has_subscribers<TickEvent>() == false);
+    REQUIRE(event_dispatcher.has_subscribers<SpawnedEvent>() == false);
+}
@@ -0,0 +1,175 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+
+/// Test events
+
+struct CollisionEvent {
+    int body;
+};
+
+struct ExplosionEvent {
+    int radius;
+};
+
+
+/// Test subscribers
+
+class LoggingSubscriber : public dispatch::EventSubscriber<CollisionEvent, ExplosionEvent>
+{
+public:
+
+    LoggingSubscriber(std::string subscriber_name, std::vector<std::string>& event_log) : name(std::move(subscriber_name)), log(event_log) {}
+
+    void handle_event(const CollisionEvent& event) override
+    {
+        log.push_back(name + " collision " + std::to_string(event.body));
+    }
+
+    void handle_event(const ExplosionEvent& event) override
+    {
+        log.push_back(name + " explosion " + std::to_string(event.radius));
+    }
+
+    std::string name;
+    std::vector<std::string>& log;
+};
+
+
+/// Child dispatcher tests
+
+TEST_CASE("Test child dispatcher handles events locally before forwarding them to its parent")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher parent_dispatcher;
+    EventDispatcher child_dispatcher;
+    LoggingSubscriber parent_subscriber { "parent", log };
+    LoggingSubscriber child_subscriber { "child", log };
+
+    REQUIRE(child_dispatcher.set_parent(&parent_dispatcher) == true);
+
+    parent_dispatcher.subscribe<CollisionEvent>(&parent_subscriber);
+    child_dispatcher.subscribe(&child_subscriber);
+
+    child_dispatcher.dispatch(CollisionEvent { 1 });
+    child_dispatcher.dispatch(ExplosionEvent { 2 });
+    parent_dispatcher.dispatch(CollisionEvent { 3 });
+
+    REQUIRE(log == std::vector<std::string> {
+        "child collision 1",
+        "parent collision 1",
+        "child explosion 2",
+        "parent collision 3",
+    });
+}
+
+TEST_CASE("Test child dispatcher forwards past ancestors without subscribers")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher root_dispatcher;
+    EventDispatcher middle_dispatcher;
+    EventDispatcher leaf_dispatcher;
+    LoggingSubscriber root_subscriber { "root", log };
+
+    middle_dispatcher.set_parent(&root_dispatcher);
+    leaf_dispatcher.set_parent(&middle_dispatcher);
+    root_dispatcher.subscribe(&root_subscriber);
+
+    leaf_dispatcher.dispatch(CollisionEvent { 1 });
+    leaf_dispatcher.dispatch_emplace<ExplosionEvent>(2);
+
+    const std::array<CollisionEvent, 2> event_list { CollisionEvent { 3 }, CollisionEvent { 4 } };
+    leaf_dispatcher.dispatch_batch<CollisionEvent>(event_list);
+
+    REQUIRE(log == std::vector<std::string> {
+        "root collision 1",
+        "root explosion 2",
+        "root collision 3",
+        "root collision 4",
+    });
+}
+
+TEST_CASE("Test lazily constructed events are not constructed when no ancestor would handle them")
+{
+    using namespace dispatch;
+
+    EventDispatcher parent_dispatcher;
+    EventDispatcher child_dispatcher;
+
+    child_dispatcher.set_parent(&parent_dispatcher);
+
+    bool constructed = false;
+
+    child_dispatcher.dispatch_lazy<CollisionEvent>([&constructed] {
+        constructed = true;
+        return CollisionEvent { 1 };
+    });
+
+    REQUIRE(constructed == false);
+}
+
+TEST_CASE("Test destroying a child dispatcher drops all of its subscriptions")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher parent_dispatcher;
+    LoggingSubscriber child_subscriber { "child", log };
+
+    {
+        EventDispatcher child_dispatcher;
+        child_dispatcher.set_parent(&parent_dispatcher);
+        child_dispatcher.subscribe(&child_subscriber);
+    }
+
+    parent_dispatcher.dispatch(CollisionEvent { 1 });
+
+    REQUIRE(log.empty());
+    REQUIRE(parent_dispatcher.has_subscribers<CollisionEvent>() == false);
+}
+
+TEST_CASE("Test dispatcher cannot be made a child of itself or of its descendants")
+{
+    using namespace dispatch;
+
+    EventDispatcher parent_dispatcher;
+    EventDispatcher child_dispatcher;
+
+    child_dispatcher.set_parent(&parent_dispatcher);
+
+    REQUIRE(parent_dispatcher.set_parent(&parent_dispatcher) == false);
+    REQUIRE(parent_dispatcher.set_parent(&child_dispatcher) == false);
+    REQUIRE(child_dispatcher.set_parent(nullptr) == true);
+    REQUIRE(parent_dispatcher.set_parent(&child_dispatcher) == true);
+}
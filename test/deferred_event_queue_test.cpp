@@ -0,0 +1,188 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "event/deferred_event_queue.h"
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <vector>
+
+
+/// Test events
+
+struct MovedEvent {
+    int entity_id;
+};
+
+struct DamagedEvent {
+    int entity_id;
+    int damage;
+};
+
+
+/// Test subscribers
+
+class FrameSubscriber : public dispatch::EventSubscriber<MovedEvent, DamagedEvent>
+{
+public:
+
+    explicit FrameSubscriber(std::string subscriber_name, std::vector<std::string>& event_log)
+        : name(std::move(subscriber_name))
+        , log(event_log)
+    {}
+
+    void handle_event(const MovedEvent& event) override
+    {
+        log.push_back(name + " moved " + std::to_string(event.entity_id));
+    }
+
+    void handle_event(const DamagedEvent& event) override
+    {
+        log.push_back(name + " damaged " + std::to_string(event.entity_id));
+    }
+
+    std::string name;
+    std::vector<std::string>& log;
+};
+
+class ChainingSubscriber : public dispatch::EventSubscriber<MovedEvent>
+{
+public:
+
+    explicit ChainingSubscriber(dispatch::DeferredEventQueue<>& event_queue)
+        : deferred_event_queue(event_queue)
+    {}
+
+    void handle_event(const MovedEvent& event) override
+    {
+        deferred_event_queue.defer(DamagedEvent { event.entity_id, 1 });
+    }
+
+    dispatch::DeferredEventQueue<>& deferred_event_queue;
+};
+
+
+/// dispatch_batch tests
+
+TEST_CASE("Test dispatch_batch has each subscriber handle the whole batch in order")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    FrameSubscriber subscriber_a { "a", log };
+    FrameSubscriber subscriber_b { "b", log };
+
+    event_dispatcher.subscribe(&subscriber_a);
+    event_dispatcher.subscribe(&subscriber_b);
+
+    const std::vector<MovedEvent> event_list { { 1 }, { 2 } };
+    event_dispatcher.dispatch_batch<MovedEvent>(event_list);
+
+    REQUIRE(log == std::vector<std::string> { "a moved 1", "a moved 2", "b moved 1", "b moved 2" });
+}
+
+
+/// DeferredEventQueue tests
+
+TEST_CASE("Test deferred events not dispatched until dispatch_deferred is called")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    DeferredEventQueue deferred_event_queue { event_dispatcher };
+    FrameSubscriber subscriber { "a", log };
+
+    event_dispatcher.subscribe(&subscriber);
+
+    deferred_event_queue.defer(MovedEvent { 1 });
+    deferred_event_queue.defer_emplace<DamagedEvent>(2, 10);
+
+    REQUIRE(log.empty());
+    REQUIRE(deferred_event_queue.get_deferred_count() == 2);
+    REQUIRE(deferred_event_queue.dispatch_deferred() == 2);
+    REQUIRE(log.size() == 2);
+    REQUIRE(deferred_event_queue.get_deferred_count() == 0);
+    REQUIRE(deferred_event_queue.dispatch_deferred() == 0);
+}
+
+TEST_CASE("Test deferred events dispatched with a multi threaded dispatcher")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation> event_dispatcher;
+    DeferredEventQueue deferred_event_queue { event_dispatcher };
+    FrameSubscriber subscriber { "a", log };
+
+    event_dispatcher.subscribe(&subscriber);
+
+    deferred_event_queue.defer(MovedEvent { 1 });
+    deferred_event_queue.defer_emplace<DamagedEvent>(2, 10);
+
+    REQUIRE(deferred_event_queue.dispatch_deferred() == 2);
+    REQUIRE(log.size() == 2);
+}
+
+TEST_CASE("Test deferred events dispatched grouped by type in the order each type was first deferred")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    DeferredEventQueue deferred_event_queue { event_dispatcher };
+    FrameSubscriber subscriber { "a", log };
+
+    event_dispatcher.subscribe(&subscriber);
+
+    deferred_event_queue.defer(MovedEvent { 1 });
+    deferred_event_queue.defer(DamagedEvent { 2, 10 });
+    deferred_event_queue.defer(MovedEvent { 3 });
+    deferred_event_queue.dispatch_deferred();
+
+    REQUIRE(log == std::vector<std::string> { "a moved 1", "a moved 3", "a damaged 2" });
+}
+
+TEST_CASE("Test events deferred while dispatching deferred events are kept for the next frame")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    DeferredEventQueue deferred_event_queue { event_dispatcher };
+    ChainingSubscriber chaining_subscriber { deferred_event_queue };
+    FrameSubscriber subscriber { "a", log };
+
+    event_dispatcher.subscribe(&chaining_subscriber);
+    event_dispatcher.subscribe(&subscriber);
+
+    deferred_event_queue.defer(MovedEvent { 1 });
+
+    REQUIRE(deferred_event_queue.dispatch_deferred() == 1);
+    REQUIRE(log == std::vector<std::string> { "a moved 1" });
+    REQUIRE(deferred_event_queue.get_deferred_count() == 1);
+    REQUIRE(deferred_event_queue.dispatch_deferred() == 1);
+    REQUIRE(log == std::vector<std::string> { "a moved 1", "a damaged 1" });
+}
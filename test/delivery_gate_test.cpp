@@ -0,0 +1,247 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "async/strand.h"
+#include "async/thread_pool.h"
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/// Test events
+
+struct TelemetryEvent {
+    int sample;
+};
+
+struct UniqueEvent {
+    std::unique_ptr<int> value;
+};
+
+
+/// Test subscribers
+
+class TelemetrySubscriber : public dispatch::EventSubscriber<TelemetryEvent, UniqueEvent>
+{
+public:
+
+    void handle_event(const TelemetryEvent& event) override
+    {
+        sample_list.push_back(event.sample);
+        handler_thread_id = std::this_thread::get_id();
+    }
+
+    void handle_event(const UniqueEvent& event) override {}
+
+    std::vector<int> sample_list;
+    std::thread::id handler_thread_id {};
+};
+
+
+/// Delivery gate tests
+
+TEST_CASE("Test delivery gate cannot be set for subscriber that is not subscribed")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_nth(2)) == false);
+}
+
+TEST_CASE("Test invalid delivery gates are rejected")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_nth(0)) == false);
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::rate_limited(1, std::chrono::nanoseconds::zero())) == false);
+    REQUIRE(event_dispatcher.set_delivery_gate<UniqueEvent>(&subscriber, DeliveryGate::debounced(std::chrono::milliseconds(1))) == false);
+}
+
+TEST_CASE("Test every nth gate handles the first event and every nth event after it")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_nth(3)) == true);
+
+    for (int sample = 0; sample < 7; ++sample) {
+        event_dispatcher.dispatch(TelemetryEvent { sample });
+    }
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 0, 3, 6 });
+}
+
+TEST_CASE("Test rate limited gate discards events once its burst is used")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::rate_limited(2, std::chrono::hours(1))) == true);
+
+    for (int sample = 0; sample < 5; ++sample) {
+        event_dispatcher.dispatch(TelemetryEvent { sample });
+    }
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 0, 1 });
+}
+
+TEST_CASE("Test rate limited gate refills over time")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::rate_limited(1, std::chrono::nanoseconds(1))) == true);
+
+    for (int sample = 0; sample < 3; ++sample) {
+        const auto begin = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() == begin) {}
+
+        event_dispatcher.dispatch(TelemetryEvent { sample });
+    }
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 0, 1, 2 });
+}
+
+TEST_CASE("Test debounced gate handles only the latest event once the quiet period has passed")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::debounced(std::chrono::hours(1))) == true);
+
+    for (int sample = 0; sample < 3; ++sample) {
+        event_dispatcher.dispatch(TelemetryEvent { sample });
+    }
+
+    REQUIRE(subscriber.sample_list.empty());
+    REQUIRE(event_dispatcher.flush_debounced() == 0);
+    REQUIRE(subscriber.sample_list.empty());
+
+    const auto later = std::chrono::steady_clock::now() + std::chrono::hours(2);
+
+    REQUIRE(event_dispatcher.flush_debounced(later) == 1);
+    REQUIRE(event_dispatcher.flush_debounced(later) == 0);
+    REQUIRE(subscriber.sample_list == std::vector<int> { 2 });
+}
+
+TEST_CASE("Test debounced event of subscriber bound to a strand is flushed onto the strand")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_strand(&subscriber, &strand);
+    event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::debounced(std::chrono::hours(1)));
+
+    event_dispatcher.dispatch(TelemetryEvent { 12345 });
+
+    REQUIRE(event_dispatcher.flush_debounced(std::chrono::steady_clock::now() + std::chrono::hours(2)) == 1);
+
+    strand.wait_idle();
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 12345 });
+    REQUIRE(subscriber.handler_thread_id != std::this_thread::get_id());
+}
+
+TEST_CASE("Test every event gate removes a delivery gate")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_nth(100));
+    event_dispatcher.dispatch(TelemetryEvent { 0 });
+    event_dispatcher.dispatch(TelemetryEvent { 1 });
+
+    REQUIRE(event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_event()) == true);
+
+    event_dispatcher.dispatch(TelemetryEvent { 2 });
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 0, 2 });
+}
+
+TEST_CASE("Test delivery gates are reset on unsubscribe")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::every_nth(100));
+    event_dispatcher.unsubscribe(&subscriber);
+    event_dispatcher.subscribe(&subscriber);
+
+    event_dispatcher.dispatch(TelemetryEvent { 0 });
+    event_dispatcher.dispatch(TelemetryEvent { 1 });
+
+    REQUIRE(subscriber.sample_list == std::vector<int> { 0, 1 });
+}
+
+TEST_CASE("Test multi threaded dispatcher gates subscriptions")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<MultiThreaded, HashStorage, NoInstrumentation> event_dispatcher;
+    TelemetrySubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_delivery_gate<TelemetryEvent>(&subscriber, DeliveryGate::debounced(std::chrono::nanoseconds::zero()));
+
+    event_dispatcher.dispatch(TelemetryEvent { 0 });
+    event_dispatcher.dispatch(TelemetryEvent { 1 });
+
+    REQUIRE(event_dispatcher.flush_debounced() == 1);
+    REQUIRE(subscriber.sample_list == std::vector<int> { 1 });
+}
@@ -0,0 +1,177 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+/// Test requests
+
+struct NameListRequest : public dispatch::Request<std::vector<std::string>> {
+    int count;
+};
+
+struct GreetingRequest : public dispatch::Request<std::unique_ptr<std::string>> {};
+struct SharedGreetingRequest : public dispatch::Request<std::shared_ptr<std::string>> {};
+struct CheckedCountRequest : public dispatch::Request<std::expected<int, int>> {};
+struct NotifyRequest : public dispatch::Request<> {};
+
+
+/// Test subscribers
+
+class FillingSubscriber : public dispatch::RequestSubscriber<NameListRequest, GreetingRequest>
+{
+public:
+
+    std::optional<std::vector<std::string>> handle_request(const NameListRequest&) override
+    {
+        return std::nullopt;
+    }
+
+    bool handle_request_into(const NameListRequest& request, std::vector<std::string>& output) override
+    {
+        output.clear();
+
+        for (int index = 0; index < request.count; ++index) {
+            output.push_back("name");
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<std::string> handle_request(const GreetingRequest&) override
+    {
+        return std::make_unique<std::string>("hello");
+    }
+};
+
+class StaticFillingSubscriber : public dispatch::StaticRequestSubscriber<StaticFillingSubscriber, NameListRequest, SharedGreetingRequest, CheckedCountRequest, NotifyRequest>
+{
+public:
+
+    std::optional<std::vector<std::string>> handle_request(const NameListRequest&)
+    {
+        return std::nullopt;
+    }
+
+    bool handle_request_into(const NameListRequest& request, std::vector<std::string>& output)
+    {
+        output.assign(request.count, "static name");
+        return true;
+    }
+
+    std::shared_ptr<std::string> handle_request(const SharedGreetingRequest&)
+    {
+        return greeting;
+    }
+
+    std::expected<int, int> handle_request(const CheckedCountRequest&)
+    {
+        return std::unexpected(-1);
+    }
+
+    void handle_request(const NotifyRequest&) {}
+
+    std::shared_ptr<std::string> greeting = std::make_shared<std::string>("shared hello");
+};
+
+
+/// dispatch_into tests
+
+TEST_CASE("Test dispatch_into lets subscribers fill caller owned output in place")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    FillingSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    std::vector<std::string> name_list;
+
+    REQUIRE(request_dispatcher.dispatch_into(NameListRequest { {}, 8 }, name_list));
+    REQUIRE(name_list.size() == 8);
+
+    const auto capacity = name_list.capacity();
+    const auto data = name_list.data();
+
+    REQUIRE(request_dispatcher.dispatch_into(NameListRequest { {}, 4 }, name_list));
+    REQUIRE(name_list.size() == 4);
+    REQUIRE(name_list.capacity() == capacity);
+    REQUIRE(name_list.data() == data);
+}
+
+TEST_CASE("Test dispatch_into moves results of subscribers without handle_request_into")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    FillingSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    std::string greeting;
+
+    REQUIRE(request_dispatcher.dispatch_into(GreetingRequest {}, greeting));
+    REQUIRE(greeting == "hello");
+}
+
+TEST_CASE("Test dispatch_into with static subscribers")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    StaticFillingSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    std::vector<std::string> name_list;
+    std::string greeting;
+    int count = 5;
+
+    REQUIRE(request_dispatcher.dispatch_into(NameListRequest { {}, 2 }, name_list));
+    REQUIRE(name_list == std::vector<std::string> { "static name", "static name" });
+
+    REQUIRE(request_dispatcher.dispatch_into(SharedGreetingRequest {}, greeting));
+    REQUIRE(greeting == "shared hello");
+    REQUIRE(*subscriber.greeting == "shared hello");
+
+    REQUIRE_FALSE(request_dispatcher.dispatch_into(CheckedCountRequest {}, count));
+    REQUIRE(count == 5);
+}
+
+TEST_CASE("Test dispatch_into returns false without a subscriber")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    std::vector<std::string> name_list { "unchanged" };
+
+    REQUIRE_FALSE(request_dispatcher.dispatch_into(NameListRequest { {}, 1 }, name_list));
+    REQUIRE(name_list == std::vector<std::string> { "unchanged" });
+}
@@ -0,0 +1,359 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/// Test events
+
+struct PingEvent {
+    int value;
+};
+
+struct PongEvent {
+    int value;
+};
+
+
+/// Test subscribers
+
+class PingSubscriber : public dispatch::EventSubscriber<PingEvent>
+{
+public:
+
+    PingSubscriber(std::string subscriber_name, std::vector<std::string>& event_log) : name(std::move(subscriber_name)), log(event_log) {}
+
+    void handle_event(const PingEvent& event) override
+    {
+        log.push_back(name + " " + std::to_string(event.value));
+    }
+
+    std::string name;
+    std::vector<std::string>& log;
+};
+
+class CountingSubscriber : public dispatch::EventSubscriber<PingEvent>
+{
+public:
+
+    void handle_event(const PingEvent&) override
+    {
+        handled_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<int> handled_count = 0;
+};
+
+// Gates another subscriber and dispatches again from inside its first handler call
+class ReconfiguringSubscriber : public dispatch::EventSubscriber<PingEvent>
+{
+public:
+
+    ReconfiguringSubscriber(dispatch::EventDispatcher& dispatcher, PingSubscriber& gated, std::vector<std::string>& event_log)
+        : event_dispatcher(dispatcher)
+        , gated_subscriber(gated)
+        , log(event_log)
+    {}
+
+    void handle_event(const PingEvent& event) override
+    {
+        log.push_back("reconfiguring " + std::to_string(event.value));
+
+        if (event.value == 1) {
+            event_dispatcher.set_delivery_gate<PingEvent>(&gated_subscriber, dispatch::DeliveryGate::debounced(std::chrono::hours(1)));
+            event_dispatcher.dispatch(PingEvent { 2 });
+        }
+    }
+
+    dispatch::EventDispatcher& event_dispatcher;
+    PingSubscriber& gated_subscriber;
+    std::vector<std::string>& log;
+};
+
+// Subscribes every added subscriber from inside its first handler call, growing the subscriber list
+class GrowingSubscriber : public dispatch::EventSubscriber<PingEvent>
+{
+public:
+
+    GrowingSubscriber(dispatch::EventDispatcher& dispatcher, std::array<CountingSubscriber, 64>& added, std::vector<std::string>& event_log)
+        : event_dispatcher(dispatcher)
+        , added_subscriber_list(added)
+        , log(event_log)
+    {}
+
+    void handle_event(const PingEvent& event) override
+    {
+        log.push_back("growing " + std::to_string(event.value));
+
+        if (event.value == 1) {
+            for (auto& added_subscriber : added_subscriber_list) {
+                event_dispatcher.subscribe(&added_subscriber);
+            }
+        }
+    }
+
+    dispatch::EventDispatcher& event_dispatcher;
+    std::array<CountingSubscriber, 64>& added_subscriber_list;
+    std::vector<std::string>& log;
+};
+
+// Unsubscribes and destroys another subscriber, then unsubscribes itself, from inside its handler
+class DestroyingSubscriber : public dispatch::EventSubscriber<PingEvent>
+{
+public:
+
+    DestroyingSubscriber(dispatch::EventDispatcher& dispatcher, std::unique_ptr<PingSubscriber>& destroyed, std::vector<std::string>& event_log)
+        : event_dispatcher(dispatcher)
+        , destroyed_subscriber(destroyed)
+        , log(event_log)
+    {}
+
+    void handle_event(const PingEvent& event) override
+    {
+        event_dispatcher.unsubscribe(destroyed_subscriber.get());
+        destroyed_subscriber.reset();
+        event_dispatcher.unsubscribe(this);
+
+        log.push_back("destroying " + std::to_string(event.value));
+    }
+
+    dispatch::EventDispatcher& event_dispatcher;
+    std::unique_ptr<PingSubscriber>& destroyed_subscriber;
+    std::vector<std::string>& log;
+};
+
+
+/// Dispatch plan tests
+
+TEST_CASE("Test dispatch follows subscription changes made after earlier dispatches")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    PingSubscriber first_subscriber { "first", log };
+    PingSubscriber second_subscriber { "second", log };
+
+    event_dispatcher.subscribe(&first_subscriber);
+    event_dispatcher.dispatch(PingEvent { 1 });
+
+    event_dispatcher.subscribe(&second_subscriber);
+    event_dispatcher.dispatch(PingEvent { 2 });
+
+    event_dispatcher.unsubscribe(&first_subscriber);
+    event_dispatcher.dispatch(PingEvent { 3 });
+
+    REQUIRE(log == std::vector<std::string> { "first 1", "first 2", "second 2", "second 3" });
+}
+
+TEST_CASE("Test dispatch follows subscription settings made after earlier dispatches")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    PingSubscriber first_subscriber { "first", log };
+    PingSubscriber second_subscriber { "second", log };
+
+    event_dispatcher.subscribe(&first_subscriber);
+    event_dispatcher.subscribe(&second_subscriber);
+    event_dispatcher.dispatch(PingEvent { 1 });
+
+    event_dispatcher.set_delivery_gate<PingEvent>(&first_subscriber, DeliveryGate::every_nth(2));
+    event_dispatcher.set_latency_budget<PingEvent>(&second_subscriber, std::chrono::hours(1));
+
+    const std::array<PingEvent, 2> event_list { PingEvent { 2 }, PingEvent { 3 } };
+    event_dispatcher.dispatch_batch<PingEvent>(event_list);
+
+    event_dispatcher.set_delivery_gate<PingEvent>(&first_subscriber, DeliveryGate::every_event());
+    event_dispatcher.dispatch(PingEvent { 4 });
+
+    REQUIRE(log == std::vector<std::string> { "first 1", "second 1", "first 2", "second 2", "second 3", "first 4", "second 4" });
+}
+
+TEST_CASE("Test subscription changed by a handler takes effect once the dispatch walking the plan returns")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    PingSubscriber gated_subscriber { "gated", log };
+    ReconfiguringSubscriber reconfiguring_subscriber { event_dispatcher, gated_subscriber, log };
+
+    event_dispatcher.subscribe(&reconfiguring_subscriber);
+    event_dispatcher.subscribe(&gated_subscriber);
+    event_dispatcher.dispatch(PingEvent { 1 });
+    event_dispatcher.dispatch(PingEvent { 3 });
+
+    REQUIRE(log == std::vector<std::string> { "reconfiguring 1", "reconfiguring 2", "gated 2", "gated 1", "reconfiguring 3" });
+}
+
+TEST_CASE("Test subscribers added by a handler while the subscriber list grows are handled from the next dispatch")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    std::array<CountingSubscriber, 64> added_subscriber_list;
+    GrowingSubscriber growing_subscriber { event_dispatcher, added_subscriber_list, log };
+    PingSubscriber gated_subscriber { "gated", log };
+
+    event_dispatcher.subscribe(&growing_subscriber);
+    event_dispatcher.subscribe(&gated_subscriber);
+    event_dispatcher.set_delivery_gate<PingEvent>(&gated_subscriber, DeliveryGate::every_nth(1));
+    event_dispatcher.dispatch(PingEvent { 1 });
+
+    REQUIRE(log == std::vector<std::string> { "growing 1", "gated 1" });
+
+    for (const auto& added_subscriber : added_subscriber_list) {
+        REQUIRE(added_subscriber.handled_count == 0);
+    }
+
+    event_dispatcher.dispatch(PingEvent { 2 });
+
+    REQUIRE(log == std::vector<std::string> { "growing 1", "gated 1", "growing 2", "gated 2" });
+
+    for (const auto& added_subscriber : added_subscriber_list) {
+        REQUIRE(added_subscriber.handled_count == 1);
+    }
+}
+
+TEST_CASE("Test subscribers unsubscribed by a handler are skipped for the rest of the dispatch")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    auto destroyed_subscriber = std::make_unique<PingSubscriber>("destroyed", log);
+    DestroyingSubscriber destroying_subscriber { event_dispatcher, destroyed_subscriber, log };
+    PingSubscriber steady_subscriber { "steady", log };
+
+    event_dispatcher.subscribe(&destroying_subscriber);
+    event_dispatcher.subscribe(destroyed_subscriber.get());
+    event_dispatcher.subscribe(&steady_subscriber);
+
+    // Both unsubscribed subscriptions have state the walk must not lose while it refers to it
+    event_dispatcher.set_latency_budget<PingEvent>(&destroying_subscriber, std::chrono::hours(1));
+    event_dispatcher.set_delivery_gate<PingEvent>(destroyed_subscriber.get(), DeliveryGate::every_nth(1));
+
+    event_dispatcher.dispatch(PingEvent { 1 });
+    event_dispatcher.dispatch(PingEvent { 2 });
+
+    REQUIRE(destroyed_subscriber == nullptr);
+    REQUIRE(log == std::vector<std::string> { "destroying 1", "steady 1", "steady 2" });
+}
+
+TEST_CASE("Test a subscriber unsubscribed part way through a batch handles none of the rest of it")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    auto destroyed_subscriber = std::make_unique<PingSubscriber>("destroyed", log);
+    DestroyingSubscriber destroying_subscriber { event_dispatcher, destroyed_subscriber, log };
+
+    event_dispatcher.subscribe(destroyed_subscriber.get());
+    event_dispatcher.subscribe(&destroying_subscriber);
+
+    const std::array<PingEvent, 3> event_list { PingEvent { 1 }, PingEvent { 2 }, PingEvent { 3 } };
+    event_dispatcher.dispatch_batch<PingEvent>(event_list);
+
+    REQUIRE(log == std::vector<std::string> { "destroyed 1", "destroyed 2", "destroyed 3", "destroying 1" });
+}
+
+TEST_CASE("Test pipelines removed by a handler are neither called nor destroyed for the rest of the dispatch")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    std::array<PipelineHandle, 2> pipeline_handle_list {};
+
+    for (auto& pipeline_handle : pipeline_handle_list) {
+        const auto pipeline_name = "pipeline " + std::to_string(&pipeline_handle - pipeline_handle_list.data());
+
+        pipeline_handle = event_dispatcher.on<PingEvent>()
+                                          .filter([&event_dispatcher, &pipeline_handle_list, &log, pipeline_name](const PingEvent&) {
+                                              for (const auto removed_pipeline_handle : pipeline_handle_list) {
+                                                  event_dispatcher.remove_pipeline(removed_pipeline_handle);
+                                              }
+
+                                              // Read from the removed pipeline itself
+                                              log.push_back(pipeline_name);
+                                              return false;
+                                          })
+                                          .map([](const PingEvent& event) { return PongEvent { event.value }; })
+                                          .to<PongEvent>();
+    }
+
+    event_dispatcher.dispatch(PingEvent { 1 });
+    event_dispatcher.dispatch(PingEvent { 2 });
+
+    REQUIRE(log == std::vector<std::string> { "pipeline 0" });
+    REQUIRE_FALSE(event_dispatcher.has_subscribers<PingEvent>());
+}
+
+TEST_CASE("Test multi threaded dispatch while subscriptions change")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<MultiThreaded, HashStorage, NoInstrumentation> event_dispatcher;
+    CountingSubscriber steady_subscriber;
+    CountingSubscriber churning_subscriber;
+
+    event_dispatcher.subscribe(&steady_subscriber);
+
+    std::atomic<bool> dispatching = true;
+    std::vector<std::thread> dispatching_thread_list;
+
+    for (int thread_index = 0; thread_index < 4; ++thread_index) {
+        dispatching_thread_list.emplace_back([&] {
+            for (int index = 0; index < 1000; ++index) {
+                event_dispatcher.dispatch(PingEvent { index });
+            }
+        });
+    }
+
+    std::thread churning_thread([&] {
+        while (dispatching.load()) {
+            event_dispatcher.subscribe(&churning_subscriber);
+            event_dispatcher.unsubscribe(&churning_subscriber);
+        }
+    });
+
+    for (auto& dispatching_thread : dispatching_thread_list) {
+        dispatching_thread.join();
+    }
+
+    dispatching = false;
+    churning_thread.join();
+
+    REQUIRE(steady_subscriber.handled_count == 4000);
+}
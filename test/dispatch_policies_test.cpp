@@ -0,0 +1,222 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+#include "shared/dispatch_policies.h"
+#include "shared/dispatch_tracer.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+/// Test events and requests
+
+struct CountedEvent {
+    int value;
+};
+
+struct DoubledEvent {
+    int value;
+};
+
+struct CountRequest : public dispatch::Request<int> {};
+
+
+/// Test subscribers
+
+class CountingSubscriber : public dispatch::EventSubscriber<CountedEvent, DoubledEvent>, public dispatch::RequestSubscriber<CountRequest>
+{
+public:
+
+    void handle_event(const CountedEvent& event) override
+    {
+        counted_total.fetch_add(event.value, std::memory_order_relaxed);
+    }
+
+    void handle_event(const DoubledEvent& event) override
+    {
+        doubled_total.fetch_add(event.value, std::memory_order_relaxed);
+    }
+
+    std::optional<int> handle_request(const CountRequest& request) override
+    {
+        return counted_total.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<int> counted_total = 0;
+    std::atomic<int> doubled_total = 0;
+};
+
+
+/// Alias tests
+
+static_assert(std::is_same_v<dispatch::EventDispatcher, dispatch::BasicEventDispatcher<dispatch::SingleThreaded, dispatch::HashStorage, dispatch::TracingInstrumentation>>);
+static_assert(std::is_same_v<dispatch::RequestDispatcher, dispatch::BasicRequestDispatcher<dispatch::SingleThreaded, dispatch::OrderedStorage, dispatch::TracingInstrumentation>>);
+
+
+/// Storage policy tests
+
+TEST_CASE("Test dispatchers work with either storage policy")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<SingleThreaded, OrderedStorage, TracingInstrumentation> event_dispatcher;
+    BasicRequestDispatcher<SingleThreaded, HashStorage, TracingInstrumentation> request_dispatcher;
+    CountingSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.subscribe(&subscriber));
+    REQUIRE(request_dispatcher.subscribe(&subscriber));
+
+    event_dispatcher.dispatch(CountedEvent { 3 });
+
+    REQUIRE(request_dispatcher.dispatch(CountRequest {}) == 3);
+}
+
+
+/// Instrumentation policy tests
+
+TEST_CASE("Test uninstrumented dispatchers record no trace spans")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<SingleThreaded, HashStorage, NoInstrumentation> event_dispatcher;
+    BasicRequestDispatcher<SingleThreaded, OrderedStorage, NoInstrumentation> request_dispatcher;
+    CountingSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    request_dispatcher.subscribe(&subscriber);
+
+    DispatchTracer::clear();
+    DispatchTracer::enable();
+
+    event_dispatcher.dispatch(CountedEvent { 1 });
+    request_dispatcher.dispatch(CountRequest {});
+
+    DispatchTracer::disable();
+
+    REQUIRE(subscriber.counted_total == 1);
+    REQUIRE(DispatchTracer::collect().empty());
+}
+
+
+/// Threading policy tests
+
+TEST_CASE("Test multi threaded dispatcher dispatches from several threads while subscriptions change")
+{
+    using namespace dispatch;
+
+    constexpr int THREAD_COUNT = 4;
+    constexpr int DISPATCH_COUNT = 10000;
+
+    BasicEventDispatcher<MultiThreaded, HashStorage, TracingInstrumentation> event_dispatcher;
+    CountingSubscriber subscriber;
+    CountingSubscriber churning_subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    std::atomic<bool> dispatching = true;
+
+    std::thread churning_thread([&] {
+        while (dispatching.load()) {
+            event_dispatcher.subscribe(&churning_subscriber);
+            event_dispatcher.unsubscribe(&churning_subscriber);
+        }
+    });
+
+    std::vector<std::thread> dispatching_thread_list;
+
+    for (int thread_index = 0; thread_index < THREAD_COUNT; ++thread_index) {
+        dispatching_thread_list.emplace_back([&event_dispatcher] {
+            for (int dispatch_index = 0; dispatch_index < DISPATCH_COUNT; ++dispatch_index) {
+                event_dispatcher.dispatch(CountedEvent { 1 });
+            }
+        });
+    }
+
+    for (auto& dispatching_thread : dispatching_thread_list) {
+        dispatching_thread.join();
+    }
+
+    dispatching = false;
+    churning_thread.join();
+
+    REQUIRE(subscriber.counted_total == THREAD_COUNT * DISPATCH_COUNT);
+}
+
+TEST_CASE("Test multi threaded dispatcher allows dispatching from inside handlers")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<MultiThreaded, HashStorage, TracingInstrumentation> event_dispatcher;
+    CountingSubscriber subscriber;
+
+    event_dispatcher.on<CountedEvent>()
+                    .map([](const CountedEvent& event) { return DoubledEvent { event.value * 2 }; })
+                    .to<DoubledEvent>();
+
+    REQUIRE(event_dispatcher.set_sticky<CountedEvent>());
+
+    event_dispatcher.dispatch(CountedEvent { 5 });
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(subscriber.counted_total == 5);
+    REQUIRE(subscriber.doubled_total == 0);
+
+    event_dispatcher.dispatch(CountedEvent { 1 });
+
+    REQUIRE(subscriber.counted_total == 6);
+    REQUIRE(subscriber.doubled_total == 2);
+}
+
+TEST_CASE("Test multi threaded request dispatcher dispatches from several threads")
+{
+    using namespace dispatch;
+
+    BasicRequestDispatcher<MultiThreaded, OrderedStorage, TracingInstrumentation> request_dispatcher;
+    CountingSubscriber subscriber;
+    subscriber.counted_total = 7;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    std::atomic<int> answered_count = 0;
+    std::vector<std::thread> dispatching_thread_list;
+
+    for (int thread_index = 0; thread_index < 4; ++thread_index) {
+        dispatching_thread_list.emplace_back([&] {
+            for (int dispatch_index = 0; dispatch_index < 1000; ++dispatch_index) {
+                answered_count += request_dispatcher.dispatch(CountRequest {}) == 7;
+            }
+        });
+    }
+
+    for (auto& dispatching_thread : dispatching_thread_list) {
+        dispatching_thread.join();
+    }
+
+    REQUIRE(answered_count == 4000);
+}
@@ -0,0 +1,266 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "ipc/event_journal.h"
+#include "ipc/event_type_registry.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+
+using namespace std::chrono_literals;
+
+
+/// Test events
+
+struct OrderEvent {
+    std::uint64_t order_id;
+    double quantity;
+};
+
+struct CancelEvent {
+    std::uint64_t order_id;
+};
+
+struct LabelEvent {
+    std::string label;
+};
+
+
+/// Test subscribers
+
+class OrderSubscriber : public dispatch::EventSubscriber<OrderEvent, CancelEvent, LabelEvent>
+{
+public:
+
+    void handle_event(const OrderEvent& event) override
+    {
+        order_id_list.push_back(event.order_id);
+    }
+
+    void handle_event(const CancelEvent& event) override
+    {
+        cancelled_order_id_list.push_back(event.order_id);
+    }
+
+    void handle_event(const LabelEvent& event) override
+    {
+        ++label_count;
+    }
+
+    std::vector<std::uint64_t> order_id_list {};
+    std::vector<std::uint64_t> cancelled_order_id_list {};
+    int label_count = 0;
+};
+
+
+/// Test helpers
+
+std::filesystem::path get_journal_path(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / ("dispatchula_" + name + "_" + std::to_string(::getpid()) + ".journal");
+}
+
+
+/// Event journal tests
+
+TEST_CASE("Test events recorded from EventDispatcher replayed in order to another EventDispatcher")
+{
+    using namespace dispatch;
+
+    const auto journal_path = get_journal_path("replay");
+
+    {
+        auto journal_writer = EventJournalWriter::create(journal_path);
+        REQUIRE(journal_writer.has_value());
+
+        EventDispatcher event_dispatcher;
+        event_dispatcher.set_recorder(&*journal_writer);
+
+        event_dispatcher.dispatch(OrderEvent { 1, 10.0 });
+        event_dispatcher.dispatch(LabelEvent { "not trivially copyable, so not recorded" });
+        event_dispatcher.dispatch(CancelEvent { 1 });
+        event_dispatcher.dispatch_emplace<OrderEvent>(2u, 20.0);
+
+        REQUIRE(journal_writer->get_record_count() == 3);
+    }
+
+    auto journal_reader = EventJournalReader::open(journal_path);
+    REQUIRE(journal_reader.has_value());
+    REQUIRE(journal_reader->get_record_count() == 3);
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+    OrderSubscriber subscriber;
+
+    event_type_registry.register_event_type<OrderEvent>();
+    event_type_registry.register_event_type<CancelEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(journal_reader->replay(event_type_registry, event_dispatcher, EventJournalReader::MAXIMUM_SPEED) == 3);
+    REQUIRE(subscriber.order_id_list == std::vector<std::uint64_t> { 1, 2 });
+    REQUIRE(subscriber.cancelled_order_id_list == std::vector<std::uint64_t> { 1 });
+    REQUIRE(subscriber.label_count == 0);
+
+    std::filesystem::remove(journal_path);
+}
+
+TEST_CASE("Test events recorded from a multi threaded dispatcher replayed to another")
+{
+    using namespace dispatch;
+
+    using SharedEventDispatcher = BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation>;
+
+    const auto journal_path = get_journal_path("shared");
+
+    {
+        auto journal_writer = EventJournalWriter::create(journal_path);
+        REQUIRE(journal_writer.has_value());
+
+        SharedEventDispatcher event_dispatcher;
+        event_dispatcher.set_recorder(&*journal_writer);
+        event_dispatcher.dispatch(OrderEvent { 1, 10.0 });
+        event_dispatcher.dispatch(CancelEvent { 1 });
+    }
+
+    auto journal_reader = EventJournalReader::open(journal_path);
+    REQUIRE(journal_reader.has_value());
+
+    EventTypeRegistry<SharedEventDispatcher> event_type_registry;
+    SharedEventDispatcher event_dispatcher;
+    OrderSubscriber subscriber;
+
+    event_type_registry.register_event_type<OrderEvent>();
+    event_type_registry.register_event_type<CancelEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(journal_reader->replay(event_type_registry, event_dispatcher, EventJournalReader::MAXIMUM_SPEED) == 2);
+    REQUIRE(subscriber.order_id_list == std::vector<std::uint64_t> { 1 });
+    REQUIRE(subscriber.cancelled_order_id_list == std::vector<std::uint64_t> { 1 });
+
+    std::filesystem::remove(journal_path);
+}
+
+TEST_CASE("Test journal grows past its initial file size")
+{
+    using namespace dispatch;
+
+    const auto journal_path = get_journal_path("grow");
+    const auto record_count = EventJournalWriter::INITIAL_FILE_SIZE / sizeof(OrderEvent);
+
+    {
+        auto journal_writer = EventJournalWriter::create(journal_path);
+        REQUIRE(journal_writer.has_value());
+
+        bool all_appended = true;
+
+        for (std::uint64_t order_id = 0; order_id < record_count; ++order_id) {
+            all_appended &= journal_writer->append(OrderEvent { order_id, 0.0 });
+        }
+
+        REQUIRE(all_appended);
+    }
+
+    auto journal_reader = EventJournalReader::open(journal_path);
+    REQUIRE(journal_reader.has_value());
+    REQUIRE(journal_reader->get_record_count() == record_count);
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+    OrderSubscriber subscriber;
+
+    event_type_registry.register_event_type<OrderEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    journal_reader->replay(event_type_registry, event_dispatcher, EventJournalReader::MAXIMUM_SPEED);
+
+    REQUIRE(subscriber.order_id_list.size() == record_count);
+    REQUIRE(subscriber.order_id_list.back() == record_count - 1);
+
+    std::filesystem::remove(journal_path);
+}
+
+TEST_CASE("Test journal replayed at original speed takes as long as the recording")
+{
+    using namespace dispatch;
+
+    const auto journal_path = get_journal_path("speed");
+
+    {
+        auto journal_writer = EventJournalWriter::create(journal_path);
+        REQUIRE(journal_writer.has_value());
+
+        journal_writer->append(CancelEvent { 1 });
+        std::this_thread::sleep_for(50ms);
+        journal_writer->append(CancelEvent { 2 });
+    }
+
+    auto journal_reader = EventJournalReader::open(journal_path);
+    REQUIRE(journal_reader.has_value());
+    REQUIRE(journal_reader->get_duration() >= 50ms);
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+
+    event_type_registry.register_event_type<CancelEvent>();
+
+    const auto original_speed_begin = std::chrono::steady_clock::now();
+    journal_reader->replay(event_type_registry, event_dispatcher, 1.0);
+    const auto original_speed_duration = std::chrono::steady_clock::now() - original_speed_begin;
+
+    REQUIRE(original_speed_duration >= 50ms);
+
+    const auto maximum_speed_begin = std::chrono::steady_clock::now();
+    journal_reader->replay(event_type_registry, event_dispatcher, EventJournalReader::MAXIMUM_SPEED);
+    const auto maximum_speed_duration = std::chrono::steady_clock::now() - maximum_speed_begin;
+
+    REQUIRE(maximum_speed_duration < 50ms);
+
+    std::filesystem::remove(journal_path);
+}
+
+TEST_CASE("Test opening a file that is not a journal fails")
+{
+    using namespace dispatch;
+
+    const auto journal_path = get_journal_path("invalid");
+
+    {
+        std::ofstream file { journal_path };
+        file << "This is not a journal, although it is long enough to hold a journal header";
+    }
+
+    REQUIRE(EventJournalReader::open(journal_path).has_value() == false);
+    REQUIRE(EventJournalReader::open(get_journal_path("missing")).has_value() == false);
+
+    std::filesystem::remove(journal_path);
+}
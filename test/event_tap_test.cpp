@@ -0,0 +1,204 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "event/event_tap.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+/// Test events
+
+struct PositionEvent {
+    int x;
+    int y;
+};
+
+struct ChatEvent {
+    std::string message;
+};
+
+
+/// Test subscribers and taps
+
+class ChatSubscriber : public dispatch::EventSubscriber<ChatEvent>
+{
+public:
+
+    void handle_event(const ChatEvent& event) override
+    {
+        log.push_back("handled " + event.message);
+    }
+
+    std::vector<std::string>& log;
+
+    explicit ChatSubscriber(std::vector<std::string>& event_log) : log(event_log) {}
+};
+
+class LoggingTap : public dispatch::EventTap
+{
+public:
+
+    explicit LoggingTap(std::vector<std::string>& event_log) : log(event_log) {}
+
+    void tap_event(const dispatch::TappedEvent& tapped_event) override
+    {
+        if (tapped_event.type_id == dispatch::type_id_v<ChatEvent>) {
+            log.push_back("tapped " + static_cast<const ChatEvent*>(tapped_event.event)->message);
+        }
+
+        else {
+            log.push_back("tapped " + std::string(tapped_event.type_name) + " of " + std::to_string(tapped_event.event_bytes.size()) + " bytes");
+        }
+    }
+
+    std::vector<std::string>& log;
+};
+
+
+/// EventTap tests
+
+TEST_CASE("Test taps see every event of every type before it is handled")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    ChatSubscriber subscriber { log };
+    LoggingTap tap { log };
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.add_tap(&tap);
+
+    event_dispatcher.dispatch(ChatEvent { "hello" });
+    event_dispatcher.dispatch(PositionEvent { 1, 2 });
+
+    REQUIRE(log == std::vector<std::string> {
+        "tapped hello",
+        "handled hello",
+        "tapped " + std::string(type_name_v<PositionEvent>) + " of " + std::to_string(sizeof(PositionEvent)) + " bytes",
+    });
+}
+
+TEST_CASE("Test lazily constructed events are constructed for taps")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    LoggingTap tap { log };
+
+    event_dispatcher.dispatch_emplace<ChatEvent>("unseen");
+    event_dispatcher.add_tap(&tap);
+    event_dispatcher.dispatch_emplace<ChatEvent>("seen");
+
+    REQUIRE(log == std::vector<std::string> { "tapped seen" });
+}
+
+TEST_CASE("Test removed taps see no more events")
+{
+    using namespace dispatch;
+
+    std::vector<std::string> log;
+    EventDispatcher event_dispatcher;
+    LoggingTap tap { log };
+
+    event_dispatcher.add_tap(&tap);
+    event_dispatcher.add_tap(&tap);
+    event_dispatcher.dispatch(ChatEvent { "once" });
+    event_dispatcher.remove_tap(&tap);
+    event_dispatcher.dispatch(ChatEvent { "never" });
+
+    REQUIRE(log == std::vector<std::string> { "tapped once" });
+}
+
+
+/// EventTapBuffer tests
+
+TEST_CASE("Test tap buffer copies events to be drained on another thread")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTapBuffer tap_buffer { 16, sizeof(PositionEvent) };
+
+    event_dispatcher.add_tap(&tap_buffer);
+
+    event_dispatcher.dispatch(PositionEvent { 1, 2 });
+    event_dispatcher.dispatch(ChatEvent { "not copied" });
+
+    REQUIRE(tap_buffer.get_buffered_count() == 2);
+
+    std::vector<PositionEvent> position_list;
+    std::vector<std::string_view> type_name_list;
+
+    std::thread draining_thread([&] {
+        tap_buffer.drain([&](const TappedEvent& tapped_event) {
+            type_name_list.push_back(tapped_event.type_name);
+
+            if (tapped_event.type_id == type_id_v<PositionEvent>) {
+                PositionEvent position_event;
+                std::memcpy(&position_event, tapped_event.event_bytes.data(), sizeof(position_event));
+                position_list.push_back(position_event);
+            }
+
+            else {
+                REQUIRE(tapped_event.event_bytes.empty());
+            }
+        });
+    });
+
+    draining_thread.join();
+
+    REQUIRE(type_name_list == std::vector<std::string_view> { type_name_v<PositionEvent>, type_name_v<ChatEvent> });
+    REQUIRE(position_list.size() == 1);
+    REQUIRE(position_list[0].x == 1);
+    REQUIRE(position_list[0].y == 2);
+    REQUIRE(tap_buffer.get_buffered_count() == 0);
+}
+
+TEST_CASE("Test full tap buffer overwrites its oldest event")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTapBuffer tap_buffer { 2, sizeof(PositionEvent) };
+
+    event_dispatcher.add_tap(&tap_buffer);
+
+    for (int x = 0; x < 3; ++x) {
+        event_dispatcher.dispatch(PositionEvent { x, 0 });
+    }
+
+    std::vector<int> x_list;
+
+    REQUIRE(tap_buffer.drain([&](const TappedEvent& tapped_event) {
+        x_list.push_back(reinterpret_cast<const PositionEvent*>(tapped_event.event_bytes.data())->x);
+    }) == 2);
+
+    REQUIRE(x_list == std::vector<int> { 1, 2 });
+    REQUIRE(tap_buffer.get_dropped_count() == 1);
+}
@@ -21,14 +21,26 @@
 
 #include "event/event_dispatcher.h"
 #include "event/event_subscriber.h"
+#include "event/latency_watchdog.h"
 
 #include "catch2/catch_test_macros.hpp"
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 
 struct EventWithData {
     int data;
 };
 struct SomethingHappenedEvent {};
+struct ExpensiveEvent {
+    explicit ExpensiveEvent(int event_data) : data(event_data) { ++construction_count; }
+
+    int data;
+
+    static inline int construction_count = 0;
+};
 
 
 class SingleSubscriber : public dispatch::EventSubscriber<SomethingHappenedEvent>
@@ -67,6 +79,77 @@ public:
 };
 
 
+class StaticMultiSubscriber : public dispatch::StaticEventSubscriber<StaticMultiSubscriber, EventWithData, SomethingHappenedEvent>
+{
+
+public:
+
+    void handle_event(const EventWithData& event)
+    {
+        event_with_data_handled = true;
+        event_data = event.data;
+    }
+
+    void handle_event(const SomethingHappenedEvent& event)
+    {
+        something_happened_event_handled = true;
+    }
+
+    bool event_with_data_handled = false;
+    std::optional<int> event_data = std::nullopt;
+
+    bool something_happened_event_handled = false;
+};
+
+class ExpensiveEventSubscriber : public dispatch::EventSubscriber<ExpensiveEvent>
+{
+
+public:
+
+    void handle_event(const ExpensiveEvent& event) override
+    {
+        event_data = event.data;
+    }
+
+    std::optional<int> event_data = std::nullopt;
+};
+
+class SlowSubscriber : public dispatch::EventSubscriber<EventWithData>
+{
+
+public:
+
+    void handle_event(const EventWithData& event) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        handled_data_list.push_back(event.data);
+    }
+
+    std::vector<int> handled_data_list {};
+};
+
+class SlowMultiSubscriber : public dispatch::EventSubscriber<EventWithData, SomethingHappenedEvent>
+{
+
+public:
+
+    void handle_event(const EventWithData& event) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        handled_data_list.push_back(event.data);
+    }
+
+    void handle_event(const SomethingHappenedEvent& event) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++something_happened_count;
+    }
+
+    std::vector<int> handled_data_list {};
+    int something_happened_count = 0;
+};
+
+
 /// Mock subscriber initialisation tests
 
 TEST_CASE("Test mock SingleSubscriber public variable initialisation")
@@ -309,3 +392,368 @@ TEST_CASE("Test no events handled when MultiSubscriber is subscribed to Somethin
     REQUIRE(subscriber.event_data.has_value() == false);
     REQUIRE(subscriber.something_happened_event_handled == false);
 }
+
+
+/// Latency watchdog tests
+
+TEST_CASE("Test no latency violation reported for subscriber without a latency budget")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    LatencyWatchdog watchdog;
+    SlowSubscriber subscriber;
+
+    event_dispatcher.set_watchdog(&watchdog);
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+
+    REQUIRE(watchdog.get_violation_count() == 0);
+    REQUIRE(subscriber.handled_data_list == std::vector<int> { 12345 });
+}
+
+TEST_CASE("Test latency budget cannot be set for subscriber that is not subscribed")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    SlowSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.set_latency_budget<EventWithData>(&subscriber, std::chrono::microseconds(100)) == false);
+}
+
+TEST_CASE("Test latency violation reported for subscriber exceeding its latency budget")
+{
+    using namespace dispatch;
+
+    std::vector<LatencyViolation> violation_list;
+
+    EventDispatcher event_dispatcher;
+    LatencyWatchdog watchdog { [&violation_list](const LatencyViolation& violation) { violation_list.push_back(violation); } };
+    SlowSubscriber subscriber;
+
+    event_dispatcher.set_watchdog(&watchdog);
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.set_latency_budget<EventWithData>(&subscriber, std::chrono::microseconds(100)) == true);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+    event_dispatcher.dispatch(EventWithData { .data = 67890 });
+
+    REQUIRE(watchdog.get_violation_count() == 2);
+    REQUIRE(violation_list.size() == 2);
+    REQUIRE(violation_list[1].event_type_name == "EventWithData");
+    REQUIRE(violation_list[1].latency > violation_list[1].budget);
+    REQUIRE(violation_list[1].violation_count == 2);
+    REQUIRE(violation_list[1].demoted == false);
+    REQUIRE(subscriber.handled_data_list == std::vector<int> { 12345, 67890 });
+}
+
+TEST_CASE("Test subscriber demoted to background delivery after reaching demotion threshold")
+{
+    using namespace dispatch;
+
+    std::vector<LatencyViolation> violation_list;
+
+    EventDispatcher event_dispatcher;
+    LatencyWatchdog watchdog { [&violation_list](const LatencyViolation& violation) { violation_list.push_back(violation); }, 1 };
+    SlowSubscriber slow_subscriber;
+    MultiSubscriber fast_subscriber;
+
+    event_dispatcher.set_watchdog(&watchdog);
+    event_dispatcher.subscribe(&slow_subscriber);
+    event_dispatcher.subscribe(&fast_subscriber);
+    event_dispatcher.set_latency_budget<EventWithData>(&slow_subscriber, std::chrono::microseconds(100));
+
+    event_dispatcher.dispatch(EventWithData { .data = 1 });
+
+    REQUIRE(violation_list.size() == 1);
+    REQUIRE(violation_list[0].demoted == true);
+
+    event_dispatcher.dispatch(EventWithData { .data = 2 });
+    event_dispatcher.dispatch(EventWithData { .data = 3 });
+
+    REQUIRE(slow_subscriber.handled_data_list == std::vector<int> { 1 });
+    REQUIRE(fast_subscriber.event_data == 3);
+    REQUIRE(watchdog.get_demoted_backlog() == 2);
+
+    std::thread background_thread { [&watchdog] { watchdog.run_demoted(); } };
+    background_thread.join();
+
+    REQUIRE(slow_subscriber.handled_data_list == std::vector<int> { 1, 2, 3 });
+    REQUIRE(watchdog.get_demoted_backlog() == 0);
+}
+
+TEST_CASE("Test demoted events discarded when subscriber unsubscribes")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    LatencyWatchdog watchdog { {}, 1 };
+    SlowSubscriber subscriber;
+
+    event_dispatcher.set_watchdog(&watchdog);
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_latency_budget<EventWithData>(&subscriber, std::chrono::microseconds(100));
+
+    event_dispatcher.dispatch(EventWithData { .data = 1 });
+    event_dispatcher.dispatch(EventWithData { .data = 2 });
+    event_dispatcher.unsubscribe(&subscriber);
+
+    REQUIRE(watchdog.run_demoted() == 0);
+    REQUIRE(subscriber.handled_data_list == std::vector<int> { 1 });
+}
+
+TEST_CASE("Test demoted events of other event types kept when subscriber unsubscribes from one event type")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    LatencyWatchdog watchdog { {}, 1 };
+    SlowMultiSubscriber subscriber;
+
+    event_dispatcher.set_watchdog(&watchdog);
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_latency_budget<EventWithData>(&subscriber, std::chrono::microseconds(100));
+    event_dispatcher.set_latency_budget<SomethingHappenedEvent>(&subscriber, std::chrono::microseconds(100));
+
+    event_dispatcher.dispatch(EventWithData { .data = 1 });
+    event_dispatcher.dispatch(EventWithData { .data = 2 });
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+    event_dispatcher.unsubscribe<EventWithData>(&subscriber);
+
+    REQUIRE(watchdog.run_demoted() == 1);
+    REQUIRE(subscriber.handled_data_list == std::vector<int> { 1 });
+    REQUIRE(subscriber.something_happened_count == 2);
+}
+
+
+/// StaticEventSubscriber tests
+
+TEST_CASE("Test StaticEventSubscriber carries no virtual function table")
+{
+    STATIC_REQUIRE(std::is_polymorphic_v<StaticMultiSubscriber> == false);
+    STATIC_REQUIRE(sizeof(StaticMultiSubscriber) < sizeof(MultiSubscriber));
+}
+
+TEST_CASE("Test events handled after StaticMultiSubscriber is subscribed to events generally")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.subscribe(&subscriber) == true);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+
+    REQUIRE(subscriber.event_with_data_handled == true);
+    REQUIRE(subscriber.event_data == 12345);
+    REQUIRE(subscriber.something_happened_event_handled == true);
+}
+
+TEST_CASE("Test events not handled after StaticMultiSubscriber is subscribed to and then unsubscribed from events generally")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.unsubscribe(&subscriber);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+
+    REQUIRE(subscriber.event_with_data_handled == false);
+    REQUIRE(subscriber.something_happened_event_handled == false);
+}
+
+TEST_CASE("Test only EventWithData handled after StaticMultiSubscriber is subscribed to EventWithData specifically")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    event_dispatcher.subscribe<EventWithData>(&subscriber);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+
+    REQUIRE(subscriber.event_with_data_handled == true);
+    REQUIRE(subscriber.something_happened_event_handled == false);
+}
+
+TEST_CASE("Test event not handled after StaticMultiSubscriber is subscribed to events generally and then unsubscribed from the specific event type")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.unsubscribe<EventWithData>(&subscriber);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+    event_dispatcher.dispatch(SomethingHappenedEvent {});
+
+    REQUIRE(subscriber.event_with_data_handled == false);
+    REQUIRE(subscriber.something_happened_event_handled == true);
+}
+
+TEST_CASE("Test virtual and static subscribers handle the same event")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    MultiSubscriber virtual_subscriber;
+    StaticMultiSubscriber static_subscriber;
+
+    event_dispatcher.subscribe(&virtual_subscriber);
+    event_dispatcher.subscribe(&static_subscriber);
+
+    event_dispatcher.dispatch(EventWithData { .data = 12345 });
+
+    REQUIRE(virtual_subscriber.event_data == 12345);
+    REQUIRE(static_subscriber.event_data == 12345);
+}
+
+
+/// Lazy dispatch tests
+
+TEST_CASE("Test has_subscribers reflects subscriptions to the given event type")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    MultiSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.has_subscribers<EventWithData>() == false);
+
+    event_dispatcher.subscribe<EventWithData>(&subscriber);
+
+    REQUIRE(event_dispatcher.has_subscribers<EventWithData>() == true);
+    REQUIRE(event_dispatcher.has_subscribers<SomethingHappenedEvent>() == false);
+
+    event_dispatcher.unsubscribe(&subscriber);
+
+    REQUIRE(event_dispatcher.has_subscribers<EventWithData>() == false);
+}
+
+TEST_CASE("Test dispatch_emplace does not construct event without subscribers")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+
+    ExpensiveEvent::construction_count = 0;
+    event_dispatcher.dispatch_emplace<ExpensiveEvent>(12345);
+
+    REQUIRE(ExpensiveEvent::construction_count == 0);
+}
+
+TEST_CASE("Test dispatch_emplace constructs event once and dispatches it to subscribers")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    ExpensiveEventSubscriber subscriber_0;
+    ExpensiveEventSubscriber subscriber_1;
+
+    event_dispatcher.subscribe(&subscriber_0);
+    event_dispatcher.subscribe(&subscriber_1);
+
+    ExpensiveEvent::construction_count = 0;
+    event_dispatcher.dispatch_emplace<ExpensiveEvent>(12345);
+
+    REQUIRE(ExpensiveEvent::construction_count == 1);
+    REQUIRE(subscriber_0.event_data == 12345);
+    REQUIRE(subscriber_1.event_data == 12345);
+}
+
+TEST_CASE("Test dispatch_lazy only calls event factory when subscribers exist")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    ExpensiveEventSubscriber subscriber;
+
+    int factory_call_count = 0;
+    auto event_factory = [&factory_call_count] {
+        ++factory_call_count;
+        return ExpensiveEvent { 12345 };
+    };
+
+    event_dispatcher.dispatch_lazy<ExpensiveEvent>(event_factory);
+
+    REQUIRE(factory_call_count == 0);
+
+    event_dispatcher.subscribe(&subscriber);
+    ExpensiveEvent::construction_count = 0;
+    event_dispatcher.dispatch_lazy<ExpensiveEvent>(event_factory);
+
+    REQUIRE(factory_call_count == 1);
+    REQUIRE(ExpensiveEvent::construction_count == 1);
+    REQUIRE(subscriber.event_data == 12345);
+}
+
+
+/// Sticky event tests
+
+TEST_CASE("Test last sticky event handled by subscriber subscribed after it was dispatched")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    MultiSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.set_sticky<EventWithData>() == true);
+
+    event_dispatcher.dispatch(EventWithData { 1 });
+    event_dispatcher.dispatch(EventWithData { 2 });
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(subscriber.event_with_data_handled == true);
+    REQUIRE(subscriber.event_data == 2);
+    REQUIRE(subscriber.something_happened_event_handled == false);
+}
+
+TEST_CASE("Test sticky event not handled by late subscriber after it is cleared")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    MultiSubscriber subscriber_0;
+    MultiSubscriber subscriber_1;
+
+    event_dispatcher.set_sticky<EventWithData>();
+    event_dispatcher.dispatch(EventWithData { 12345 });
+    event_dispatcher.clear_sticky_event<EventWithData>();
+    event_dispatcher.subscribe(&subscriber_0);
+
+    REQUIRE(subscriber_0.event_with_data_handled == false);
+
+    event_dispatcher.dispatch(EventWithData { 12345 });
+    event_dispatcher.set_sticky<EventWithData>(false);
+    event_dispatcher.subscribe<EventWithData>(&subscriber_1);
+
+    REQUIRE(subscriber_0.event_with_data_handled == true);
+    REQUIRE(subscriber_1.event_with_data_handled == false);
+}
+
+TEST_CASE("Test sticky event constructed by dispatch_emplace without subscribers")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    ExpensiveEventSubscriber subscriber;
+
+    event_dispatcher.set_sticky<ExpensiveEvent>();
+    event_dispatcher.dispatch_emplace<ExpensiveEvent>(12345);
+    event_dispatcher.subscribe(&subscriber);
+
+    REQUIRE(subscriber.event_data == 12345);
+}
@@ -0,0 +1,152 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+
+/// Test events and requests
+
+struct TickEvent {
+    int frame;
+};
+
+struct FrameRequest : public dispatch::Request<int> {};
+
+
+/// Test subscribers
+
+class FrameSubscriber : public dispatch::EventSubscriber<TickEvent>, public dispatch::RequestSubscriber<FrameRequest>
+{
+public:
+
+    void handle_event(const TickEvent& event) override
+    {
+        frame = event.frame;
+    }
+
+    std::optional<int> handle_request(const FrameRequest& request) override
+    {
+        return frame;
+    }
+
+    int frame = 0;
+};
+
+
+/// Test memory resource
+
+class CountingMemoryResource : public std::pmr::memory_resource
+{
+public:
+
+    std::size_t allocation_count = 0;
+    std::size_t allocated_size = 0;
+
+private:
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override
+    {
+        ++allocation_count;
+        allocated_size += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override
+    {
+        allocated_size -= size;
+        std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+
+/// Memory resource tests
+
+TEST_CASE("Test event dispatcher allocates its storage from the given memory resource")
+{
+    using namespace dispatch;
+
+    CountingMemoryResource memory_resource;
+    FrameSubscriber subscriber;
+
+    {
+        EventDispatcher event_dispatcher { &memory_resource };
+        event_dispatcher.subscribe<TickEvent>(&subscriber);
+
+        // One lookup table node, its bucket array, and the subscriber list
+        REQUIRE(memory_resource.allocation_count >= 3);
+
+        event_dispatcher.dispatch(TickEvent { 7 });
+        REQUIRE(subscriber.frame == 7);
+    }
+
+    REQUIRE(memory_resource.allocated_size == 0);
+}
+
+TEST_CASE("Test request dispatcher allocates its storage from the given memory resource")
+{
+    using namespace dispatch;
+
+    CountingMemoryResource memory_resource;
+    FrameSubscriber subscriber;
+    subscriber.frame = 3;
+
+    {
+        RequestDispatcher request_dispatcher { &memory_resource };
+        request_dispatcher.subscribe<FrameRequest>(&subscriber);
+
+        REQUIRE(memory_resource.allocation_count == 1);
+        REQUIRE(request_dispatcher.dispatch(FrameRequest {}) == 3);
+    }
+
+    REQUIRE(memory_resource.allocated_size == 0);
+}
+
+TEST_CASE("Test dispatchers run entirely from a fixed arena")
+{
+    using namespace dispatch;
+
+    std::byte buffer[16 * 1024];
+    std::pmr::monotonic_buffer_resource arena { buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+    FrameSubscriber subscriber;
+
+    EventDispatcher event_dispatcher { &arena };
+    RequestDispatcher request_dispatcher { &arena };
+
+    REQUIRE(event_dispatcher.subscribe<TickEvent>(&subscriber));
+    REQUIRE(request_dispatcher.subscribe<FrameRequest>(&subscriber));
+
+    event_dispatcher.dispatch(TickEvent { 5 });
+
+    REQUIRE(request_dispatcher.dispatch(FrameRequest {}) == 5);
+}
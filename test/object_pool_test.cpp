@@ -0,0 +1,190 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "request/object_pool.h"
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/// Test results and requests
+
+struct Mesh {
+    explicit Mesh(int mesh_vertex_count) : vertex_count(mesh_vertex_count)
+    {
+        if (mesh_vertex_count < 0) {
+            throw std::invalid_argument("negative vertex count");
+        }
+
+        ++live_count;
+    }
+
+    ~Mesh() { --live_count; }
+
+    int vertex_count;
+
+    static inline int live_count = 0;
+};
+
+struct MeshRequest : public dispatch::Request<dispatch::PooledPtr<Mesh>> {
+    int vertex_count;
+};
+
+struct SharedMeshRequest : public dispatch::Request<std::shared_ptr<Mesh>> {
+    int vertex_count;
+};
+
+
+/// Test subscribers
+
+class MeshSubscriber : public dispatch::RequestSubscriber<MeshRequest, SharedMeshRequest>
+{
+public:
+
+    dispatch::PooledPtr<Mesh> handle_request(const MeshRequest& request) override
+    {
+        return mesh_pool.make_unique(request.vertex_count);
+    }
+
+    std::shared_ptr<Mesh> handle_request(const SharedMeshRequest& request) override
+    {
+        return mesh_pool.make_shared(request.vertex_count);
+    }
+
+    dispatch::ObjectPool<Mesh> mesh_pool { 2 };
+};
+
+
+/// ObjectPool tests
+
+TEST_CASE("Test pooled request results are recycled instead of freed")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    MeshSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    const Mesh* first_address = nullptr;
+
+    {
+        auto mesh = request_dispatcher.dispatch(MeshRequest { .vertex_count = 3 });
+        REQUIRE(mesh->vertex_count == 3);
+        first_address = mesh.get();
+    }
+
+    REQUIRE(Mesh::live_count == 0);
+
+    auto mesh = request_dispatcher.dispatch(MeshRequest { .vertex_count = 4 });
+
+    REQUIRE(mesh.get() == first_address);
+    REQUIRE(mesh->vertex_count == 4);
+    REQUIRE(subscriber.mesh_pool.get_fallback_count() == 0);
+}
+
+TEST_CASE("Test pooled shared request results return to the pool with their control block")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    MeshSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+
+    for (int request_index = 0; request_index < 8; ++request_index) {
+        auto mesh = request_dispatcher.dispatch(SharedMeshRequest { .vertex_count = request_index });
+        std::weak_ptr<Mesh> weak_mesh = mesh;
+
+        REQUIRE(mesh->vertex_count == request_index);
+    }
+
+    REQUIRE(Mesh::live_count == 0);
+    REQUIRE(subscriber.mesh_pool.get_fallback_count() == 0);
+}
+
+TEST_CASE("Test object pool falls back to the heap when every slot is in use")
+{
+    using namespace dispatch;
+
+    ObjectPool<Mesh> mesh_pool { 1 };
+
+    auto first_mesh = mesh_pool.make_unique(1);
+    auto second_mesh = mesh_pool.make_shared(2);
+
+    REQUIRE(mesh_pool.get_fallback_count() == 1);
+    REQUIRE(second_mesh->vertex_count == 2);
+
+    first_mesh.reset();
+    second_mesh.reset();
+
+    REQUIRE(Mesh::live_count == 0);
+
+    auto third_mesh = mesh_pool.make_unique(3);
+
+    REQUIRE(mesh_pool.get_fallback_count() == 1);
+}
+
+TEST_CASE("Test object pool slot returned when the pooled object's constructor throws")
+{
+    using namespace dispatch;
+
+    ObjectPool<Mesh> mesh_pool { 1 };
+
+    REQUIRE_THROWS_AS(mesh_pool.make_unique(-1), std::invalid_argument);
+
+    auto mesh = mesh_pool.make_unique(1);
+
+    REQUIRE(mesh_pool.get_fallback_count() == 0);
+    REQUIRE(Mesh::live_count == 1);
+}
+
+TEST_CASE("Test object pool shared between threads")
+{
+    using namespace dispatch;
+
+    constexpr int THREAD_COUNT = 4;
+    constexpr int OBJECT_COUNT = 10000;
+
+    ObjectPool<std::string> string_pool { THREAD_COUNT * 2 };
+    std::vector<std::thread> thread_list;
+
+    for (int thread_index = 0; thread_index < THREAD_COUNT; ++thread_index) {
+        thread_list.emplace_back([&string_pool, thread_index] {
+            for (int object_index = 0; object_index < OBJECT_COUNT; ++object_index) {
+                auto first_string = string_pool.make_unique(std::to_string(thread_index));
+                auto second_string = string_pool.make_unique(*first_string);
+            }
+        });
+    }
+
+    for (auto& thread : thread_list) {
+        thread.join();
+    }
+
+    REQUIRE(string_pool.get_fallback_count() == 0);
+}
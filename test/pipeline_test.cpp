@@ -0,0 +1,168 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <vector>
+
+
+/// Test events
+
+struct KeyPressedEvent {
+    char key;
+    int timestamp;
+};
+
+struct JumpEvent {
+    int timestamp;
+};
+
+struct LandedEvent {
+    explicit LandedEvent(const JumpEvent& jump_event) : timestamp(jump_event.timestamp + 10) {}
+
+    int timestamp;
+};
+
+
+/// Test subscribers
+
+class JumpSubscriber : public dispatch::EventSubscriber<JumpEvent, LandedEvent>
+{
+public:
+
+    void handle_event(const JumpEvent& event) override
+    {
+        log.push_back("jump " + std::to_string(event.timestamp));
+    }
+
+    void handle_event(const LandedEvent& event) override
+    {
+        log.push_back("landed " + std::to_string(event.timestamp));
+    }
+
+    std::vector<std::string> log;
+};
+
+
+/// Pipeline tests
+
+TEST_CASE("Test pipeline filters and maps events before dispatching them")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    JumpSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    const auto pipeline_handle = event_dispatcher.on<KeyPressedEvent>()
+                                                 .filter([](const KeyPressedEvent& event) { return event.key == ' '; })
+                                                 .map([](const KeyPressedEvent& event) { return event.timestamp; })
+                                                 .to<JumpEvent>();
+
+    REQUIRE(pipeline_handle);
+    REQUIRE(event_dispatcher.has_subscribers<KeyPressedEvent>());
+
+    event_dispatcher.dispatch(KeyPressedEvent { 'a', 1 });
+    event_dispatcher.dispatch(KeyPressedEvent { ' ', 2 });
+
+    REQUIRE(subscriber.log == std::vector<std::string> { "jump 2" });
+}
+
+TEST_CASE("Test pipeline stages run in the order they were added")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    JumpSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    event_dispatcher.on<KeyPressedEvent>()
+                    .map([](const KeyPressedEvent& event) { return JumpEvent { event.timestamp * 2 }; })
+                    .filter([](const JumpEvent& event) { return event.timestamp > 2; })
+                    .to<LandedEvent>();
+
+    event_dispatcher.dispatch(KeyPressedEvent { ' ', 1 });
+    event_dispatcher.dispatch(KeyPressedEvent { ' ', 2 });
+
+    REQUIRE(subscriber.log == std::vector<std::string> { "landed 14" });
+}
+
+TEST_CASE("Test pipeline output reaches subscribers that subscribe after the pipeline is registered")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    JumpSubscriber subscriber;
+
+    event_dispatcher.on<JumpEvent>().to<LandedEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    event_dispatcher.dispatch(JumpEvent { 1 });
+
+    REQUIRE(subscriber.log == std::vector<std::string> { "landed 11", "jump 1" });
+}
+
+TEST_CASE("Test stateful pipeline stages keep their state between events")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    JumpSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    event_dispatcher.on<KeyPressedEvent>()
+                    .filter([press_count = 0](const KeyPressedEvent&) mutable { return ++press_count % 2 == 0; })
+                    .map(&KeyPressedEvent::timestamp)
+                    .to<JumpEvent>();
+
+    for (int timestamp = 1; timestamp <= 4; ++timestamp) {
+        event_dispatcher.dispatch(KeyPressedEvent { ' ', timestamp });
+    }
+
+    REQUIRE(subscriber.log == std::vector<std::string> { "jump 2", "jump 4" });
+}
+
+TEST_CASE("Test removed pipeline no longer dispatches")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    JumpSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    const auto pipeline_handle = event_dispatcher.on<KeyPressedEvent>()
+                                                 .map(&KeyPressedEvent::timestamp)
+                                                 .to<JumpEvent>();
+
+    REQUIRE(event_dispatcher.remove_pipeline(pipeline_handle));
+    REQUIRE_FALSE(event_dispatcher.remove_pipeline(pipeline_handle));
+    REQUIRE_FALSE(event_dispatcher.has_subscribers<KeyPressedEvent>());
+
+    event_dispatcher.dispatch(KeyPressedEvent { ' ', 1 });
+
+    REQUIRE(subscriber.log.empty());
+}
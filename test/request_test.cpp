@@ -125,6 +125,44 @@ public:
     bool do_something_request_handled = false;
 };
 
+class StaticMultiSubscriber : public dispatch::StaticRequestSubscriber<StaticMultiSubscriber,
+                                                                       DoSomethingRequest,
+                                                                       GiveMeStuffRequest,
+                                                                       GiveMeExpectedStuffOrErrorRequest,
+                                                                       GiveMeUniquePointersRequest,
+                                                                       ReadBackMyDataRequest>
+{
+
+public:
+
+    void handle_request(const DoSomethingRequest& request)
+    {
+        do_something_request_handled = true;
+    }
+
+    std::optional<int> handle_request(const GiveMeStuffRequest& request)
+    {
+        return 12345;
+    }
+
+    std::expected<int, ErrorMessage> handle_request(const GiveMeExpectedStuffOrErrorRequest& request)
+    {
+        return 12345;
+    }
+
+    std::unique_ptr<int> handle_request(const GiveMeUniquePointersRequest& request)
+    {
+        return std::make_unique<int> ( 12345 );
+    }
+
+    std::optional<std::string> handle_request(const ReadBackMyDataRequest& request)
+    {
+        return std::to_string(request.data);
+    }
+
+    bool do_something_request_handled = false;
+};
+
 
 /// Return type tests
 
@@ -604,4 +642,76 @@ TEST_CASE("Test request with string return type returns `std::nullopt` when no s
     auto result = request_dispatcher.dispatch(request);
 
     REQUIRE(result.has_value() == false);
+}
+
+
+/// StaticRequestSubscriber tests
+
+TEST_CASE("Test StaticRequestSubscriber carries no virtual function table")
+{
+    STATIC_REQUIRE(std::is_polymorphic_v<StaticMultiSubscriber> == false);
+    STATIC_REQUIRE(sizeof(StaticMultiSubscriber) < sizeof(MultiSubscriber));
+}
+
+TEST_CASE("Test requests handled after StaticMultiSubscriber is subscribed to requests generally")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    REQUIRE(request_dispatcher.subscribe(&subscriber) == true);
+
+    request_dispatcher.dispatch(DoSomethingRequest {});
+
+    REQUIRE(subscriber.do_something_request_handled == true);
+    REQUIRE(request_dispatcher.dispatch(GiveMeStuffRequest {}) == 12345);
+    REQUIRE(request_dispatcher.dispatch(GiveMeExpectedStuffOrErrorRequest {}) == 12345);
+    REQUIRE(*request_dispatcher.dispatch(GiveMeUniquePointersRequest {}) == 12345);
+    REQUIRE(request_dispatcher.dispatch(ReadBackMyDataRequest { {}, 12345 }) == "12345");
+}
+
+TEST_CASE("Test requests not handled after StaticMultiSubscriber is subscribed to and then unsubscribed from requests generally")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+    request_dispatcher.unsubscribe(&subscriber);
+
+    request_dispatcher.dispatch(DoSomethingRequest {});
+
+    REQUIRE(subscriber.do_something_request_handled == false);
+    REQUIRE(request_dispatcher.dispatch(GiveMeStuffRequest {}).has_value() == false);
+}
+
+TEST_CASE("Test only specified requests handled after StaticMultiSubscriber is subscribed to specific request types")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    StaticMultiSubscriber subscriber;
+
+    REQUIRE(request_dispatcher.subscribe<GiveMeStuffRequest, ReadBackMyDataRequest>(&subscriber) == true);
+
+    request_dispatcher.dispatch(DoSomethingRequest {});
+
+    REQUIRE(subscriber.do_something_request_handled == false);
+    REQUIRE(request_dispatcher.dispatch(GiveMeStuffRequest {}) == 12345);
+    REQUIRE(request_dispatcher.dispatch(ReadBackMyDataRequest { {}, 12345 }) == "12345");
+    REQUIRE(request_dispatcher.dispatch(GiveMeUniquePointersRequest {}) == nullptr);
+}
+
+TEST_CASE("Test StaticMultiSubscriber cannot subscribe to request type already subscribed to by another subscriber")
+{
+    using namespace dispatch;
+
+    RequestDispatcher request_dispatcher;
+    MultiSubscriber virtual_subscriber;
+    StaticMultiSubscriber static_subscriber;
+
+    REQUIRE(request_dispatcher.subscribe(&virtual_subscriber) == true);
+    REQUIRE(request_dispatcher.subscribe<GiveMeStuffRequest>(&static_subscriber) == false);
 }
\ No newline at end of file
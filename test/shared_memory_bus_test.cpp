@@ -0,0 +1,362 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "ipc/event_type_registry.h"
+#include "ipc/shared_memory_bus.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+using namespace std::chrono_literals;
+
+
+/// Test events
+
+struct QuoteEvent {
+    std::uint64_t sequence;
+    double price;
+};
+
+struct HeartbeatEvent {
+    std::uint32_t process_id;
+};
+
+struct OversizedEvent {
+    char data[1024];
+};
+
+// Every word holds the event type's tag, so a payload written by another event type, or torn
+// between two events, is detected
+template<std::uint64_t TAG>
+struct TaggedEvent {
+    std::uint64_t word_list[64];
+
+    static constexpr TaggedEvent make()
+    {
+        TaggedEvent event {};
+
+        for (auto& word : event.word_list) {
+            word = TAG;
+        }
+
+        return event;
+    }
+
+    bool is_intact() const
+    {
+        return std::all_of(std::begin(word_list), std::end(word_list), [](std::uint64_t word) { return word == TAG; });
+    }
+};
+
+using FirstProducerEvent = TaggedEvent<0x1111111111111111>;
+using SecondProducerEvent = TaggedEvent<0x2222222222222222>;
+
+
+/// Test subscribers
+
+class QuoteSubscriber : public dispatch::EventSubscriber<QuoteEvent>
+{
+public:
+
+    void handle_event(const QuoteEvent& event) override
+    {
+        out_of_order |= event.sequence != handled_count;
+        ++handled_count;
+        last_price = event.price;
+    }
+
+    std::uint64_t handled_count = 0;
+    double last_price = 0.0;
+    bool out_of_order = false;
+};
+
+
+class TaggedSubscriber : public dispatch::EventSubscriber<FirstProducerEvent, SecondProducerEvent, HeartbeatEvent>
+{
+public:
+
+    void handle_event(const FirstProducerEvent& event) override
+    {
+        corrupt_count += !event.is_intact();
+        ++handled_count;
+    }
+
+    void handle_event(const SecondProducerEvent& event) override
+    {
+        corrupt_count += !event.is_intact();
+        ++handled_count;
+    }
+
+    void handle_event(const HeartbeatEvent& event) override
+    {
+        done = true;
+    }
+
+    std::uint64_t handled_count = 0;
+    std::uint64_t corrupt_count = 0;
+    bool done = false;
+};
+
+
+/// Test helpers
+
+// Runs `function` in a forked child process, which exits with the returned status
+template<class FUNCTION_TYPE>
+pid_t fork_process(FUNCTION_TYPE function)
+{
+    const pid_t process_id = ::fork();
+
+    if (process_id == 0) {
+        ::_exit(function());
+    }
+
+    return process_id;
+}
+
+int wait_for_exit_status(pid_t process_id)
+{
+    int status = 0;
+    ::waitpid(process_id, &status, 0);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+
+/// SharedMemoryBus tests
+
+TEST_CASE("Test SharedMemoryBus dispatches published events of registered types in order")
+{
+    using namespace dispatch;
+
+    auto bus = SharedMemoryBus::create_anonymous(64, sizeof(QuoteEvent));
+    REQUIRE(bus.has_value());
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+    QuoteSubscriber subscriber;
+
+    event_type_registry.register_event_type<QuoteEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    bus->publish(QuoteEvent { 0, 1.5 });
+    bus->publish(HeartbeatEvent { 1 });
+    bus->publish(QuoteEvent { 1, 2.5 });
+
+    REQUIRE(bus->poll(event_type_registry, event_dispatcher) == 2);
+    REQUIRE(subscriber.handled_count == 2);
+    REQUIRE(subscriber.last_price == 2.5);
+    REQUIRE(subscriber.out_of_order == false);
+    REQUIRE(bus->poll(event_type_registry, event_dispatcher) == 0);
+}
+
+TEST_CASE("Test SharedMemoryBus dispatches registered types with a multi threaded dispatcher")
+{
+    using namespace dispatch;
+
+    using SharedEventDispatcher = BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation>;
+
+    auto bus = SharedMemoryBus::create_anonymous(64, sizeof(QuoteEvent));
+    REQUIRE(bus.has_value());
+
+    EventTypeRegistry<SharedEventDispatcher> event_type_registry;
+    SharedEventDispatcher event_dispatcher;
+    QuoteSubscriber subscriber;
+
+    event_type_registry.register_event_type<QuoteEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    bus->publish(QuoteEvent { 0, 1.5 });
+    bus->publish(HeartbeatEvent { 1 });
+
+    REQUIRE(bus->poll(event_type_registry, event_dispatcher) == 1);
+    REQUIRE(subscriber.handled_count == 1);
+}
+
+TEST_CASE("Test SharedMemoryBus refuses events larger than its maximum event size")
+{
+    using namespace dispatch;
+
+    auto bus = SharedMemoryBus::create_anonymous(8, sizeof(QuoteEvent));
+    REQUIRE(bus.has_value());
+
+    REQUIRE(bus->publish(OversizedEvent {}) == false);
+}
+
+TEST_CASE("Test SharedMemoryBus counts events overwritten before they were read as lost")
+{
+    using namespace dispatch;
+
+    auto bus = SharedMemoryBus::create_anonymous(8, sizeof(QuoteEvent));
+    REQUIRE(bus.has_value());
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+
+    event_type_registry.register_event_type<QuoteEvent>();
+
+    for (std::uint64_t sequence = 0; sequence < 20; ++sequence) {
+        bus->publish(QuoteEvent { sequence, 0.0 });
+    }
+
+    REQUIRE(bus->poll(event_type_registry, event_dispatcher) == 8);
+    REQUIRE(bus->get_lost_count() == 12);
+}
+
+TEST_CASE("Test named SharedMemoryBus opened by name receives events published after it was opened")
+{
+    using namespace dispatch;
+
+    const std::string name = "/dispatchula_test_" + std::to_string(::getpid());
+
+    auto publishing_bus = SharedMemoryBus::create(name, 64, sizeof(QuoteEvent));
+    REQUIRE(publishing_bus.has_value());
+
+    publishing_bus->publish(QuoteEvent { 12345, 0.0 });
+
+    auto receiving_bus = SharedMemoryBus::open(name);
+    SharedMemoryBus::remove(name);
+    REQUIRE(receiving_bus.has_value());
+
+    EventTypeRegistry event_type_registry;
+    EventDispatcher event_dispatcher;
+    QuoteSubscriber subscriber;
+
+    event_type_registry.register_event_type<QuoteEvent>();
+    event_dispatcher.subscribe(&subscriber);
+
+    publishing_bus->publish(QuoteEvent { 0, 1.0 });
+
+    REQUIRE(receiving_bus->poll(event_type_registry, event_dispatcher) == 1);
+    REQUIRE(subscriber.out_of_order == false);
+    REQUIRE(SharedMemoryBus::open(name).has_value() == false);
+}
+
+TEST_CASE("Test events published by a forked producer process are received by a forked consumer process")
+{
+    using namespace dispatch;
+
+    constexpr std::uint64_t event_count = 100000;
+
+    auto bus = SharedMemoryBus::create_anonymous(event_count, sizeof(QuoteEvent));
+    REQUIRE(bus.has_value());
+
+    const auto consumer_process_id = fork_process([&bus] {
+        EventTypeRegistry event_type_registry;
+        EventDispatcher event_dispatcher;
+        QuoteSubscriber subscriber;
+
+        event_type_registry.register_event_type<QuoteEvent>();
+        event_dispatcher.subscribe(&subscriber);
+
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+
+        while (subscriber.handled_count < event_count && std::chrono::steady_clock::now() < deadline) {
+            bus->wait(event_type_registry, event_dispatcher, 100ms);
+        }
+
+        const bool success = subscriber.handled_count == event_count && !subscriber.out_of_order && bus->get_lost_count() == 0;
+        return success ? 0 : 1;
+    });
+
+    const auto producer_process_id = fork_process([&bus] {
+        for (std::uint64_t sequence = 0; sequence < event_count; ++sequence) {
+            bus->publish(QuoteEvent { sequence, static_cast<double>(sequence) });
+        }
+
+        return 0;
+    });
+
+    REQUIRE(wait_for_exit_status(producer_process_id) == 0);
+    REQUIRE(wait_for_exit_status(consumer_process_id) == 0);
+}
+
+TEST_CASE("Test events published by two forked producers into a tiny ring are never received with another event's payload")
+{
+    using namespace dispatch;
+
+    constexpr std::uint64_t event_count = 200000;
+
+    auto bus = SharedMemoryBus::create_anonymous(2, sizeof(FirstProducerEvent));
+    REQUIRE(bus.has_value());
+
+    const auto consumer_process_id = fork_process([&bus] {
+        EventTypeRegistry event_type_registry;
+        EventDispatcher event_dispatcher;
+        TaggedSubscriber subscriber;
+
+        event_type_registry.register_event_type<FirstProducerEvent>();
+        event_type_registry.register_event_type<SecondProducerEvent>();
+        event_type_registry.register_event_type<HeartbeatEvent>();
+        event_dispatcher.subscribe(&subscriber);
+
+        const auto deadline = std::chrono::steady_clock::now() + 20s;
+
+        while (!subscriber.done && std::chrono::steady_clock::now() < deadline) {
+            bus->poll(event_type_registry, event_dispatcher);
+        }
+
+        const bool success = subscriber.done && subscriber.handled_count > 0 && subscriber.corrupt_count == 0;
+        return success ? 0 : 1;
+    });
+
+    const auto first_producer_process_id = fork_process([&bus] {
+        for (std::uint64_t sequence = 0; sequence < event_count; ++sequence) {
+            bus->publish(FirstProducerEvent::make());
+        }
+
+        return 0;
+    });
+
+    const auto second_producer_process_id = fork_process([&bus] {
+        for (std::uint64_t sequence = 0; sequence < event_count; ++sequence) {
+            bus->publish(SecondProducerEvent::make());
+        }
+
+        return 0;
+    });
+
+    REQUIRE(wait_for_exit_status(first_producer_process_id) == 0);
+    REQUIRE(wait_for_exit_status(second_producer_process_id) == 0);
+
+    // Published until received, since the consumer may miss any single event in so small a ring
+    const auto done_deadline = std::chrono::steady_clock::now() + 20s;
+    int status = 0;
+
+    while (::waitpid(consumer_process_id, &status, WNOHANG) == 0 && std::chrono::steady_clock::now() < done_deadline) {
+        bus->publish(HeartbeatEvent { 0 });
+        std::this_thread::sleep_for(1ms);
+    }
+
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+}
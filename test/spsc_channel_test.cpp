@@ -0,0 +1,212 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "async/spsc_channel.h"
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+
+/// Test events
+
+struct StageEvent {
+    std::uint64_t sequence;
+};
+
+
+/// Test subscribers
+
+class StageSubscriber : public dispatch::EventSubscriber<StageEvent>
+{
+public:
+
+    void handle_event(const StageEvent& event) override
+    {
+        out_of_order |= event.sequence != handled_count;
+        ++handled_count;
+    }
+
+    std::atomic<std::uint64_t> handled_count = 0;
+    bool out_of_order = false;
+};
+
+class ThrowingSubscriber : public dispatch::EventSubscriber<std::shared_ptr<int>>
+{
+public:
+
+    void handle_event(const std::shared_ptr<int>& event) override
+    {
+        if (++handled_count == 2) {
+            throw std::runtime_error("handler failed");
+        }
+    }
+
+    int handled_count = 0;
+};
+
+
+/// SpscChannel tests
+
+TEST_CASE("Test SpscChannel capacity rounded up to a power of two")
+{
+    using namespace dispatch;
+
+    SpscChannel<int> channel { 100 };
+
+    REQUIRE(channel.get_capacity() == 128);
+}
+
+TEST_CASE("Test SpscChannel refuses events when full")
+{
+    using namespace dispatch;
+
+    SpscChannel<int> channel { 2 };
+
+    REQUIRE(channel.try_push(1) == true);
+    REQUIRE(channel.try_push(2) == true);
+    REQUIRE(channel.try_push(3) == false);
+    REQUIRE(channel.try_pop() == 1);
+    REQUIRE(channel.try_push(3) == true);
+    REQUIRE(channel.try_pop() == 2);
+    REQUIRE(channel.try_pop() == 3);
+    REQUIRE(channel.try_pop().has_value() == false);
+}
+
+TEST_CASE("Test written events not visible to consumer until published")
+{
+    using namespace dispatch;
+
+    SpscChannel<int> channel { 8 };
+
+    channel.try_write(1);
+    channel.try_write(2);
+
+    REQUIRE(channel.try_pop().has_value() == false);
+
+    channel.publish();
+
+    REQUIRE(channel.try_pop() == 1);
+    REQUIRE(channel.try_pop() == 2);
+}
+
+TEST_CASE("Test SpscChannel destroys events that were never consumed")
+{
+    using namespace dispatch;
+
+    auto counted = std::make_shared<int>(0);
+
+    {
+        SpscChannel<std::shared_ptr<int>> channel { 4 };
+        channel.try_push(counted);
+        channel.try_push(counted);
+
+        REQUIRE(counted.use_count() == 3);
+    }
+
+    REQUIRE(counted.use_count() == 1);
+}
+
+TEST_CASE("Test events consumed before a throwing handler are destroyed exactly once")
+{
+    using namespace dispatch;
+
+    auto counted = std::make_shared<int>(0);
+
+    EventDispatcher event_dispatcher;
+    ThrowingSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    {
+        SpscChannel<std::shared_ptr<int>> channel { 4 };
+        channel.try_push(counted);
+        channel.try_push(counted);
+        channel.try_push(counted);
+
+        REQUIRE_THROWS_AS(channel.dispatch_available(event_dispatcher), std::runtime_error);
+        REQUIRE(counted.use_count() == 2);
+        REQUIRE(channel.dispatch_available(event_dispatcher) == 1);
+        REQUIRE(counted.use_count() == 1);
+    }
+
+    REQUIRE(subscriber.handled_count == 3);
+    REQUIRE(counted.use_count() == 1);
+}
+
+TEST_CASE("Test SpscChannel dispatches published events with a multi threaded dispatcher")
+{
+    using namespace dispatch;
+
+    SpscChannel<StageEvent> channel { 8 };
+    BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation> event_dispatcher;
+    StageSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    channel.try_push(StageEvent { 0 });
+    channel.try_push(StageEvent { 1 });
+
+    REQUIRE(channel.dispatch_available(event_dispatcher) == 2);
+    REQUIRE(subscriber.handled_count == 2);
+    REQUIRE(subscriber.out_of_order == false);
+}
+
+TEST_CASE("Test events forwarded from one dispatcher are dispatched in order by another dispatcher on another thread")
+{
+    using namespace dispatch;
+
+    constexpr std::uint64_t event_count = 200000;
+
+    SpscChannel<StageEvent> channel { 1024 };
+
+    EventDispatcher stage_b_dispatcher;
+    StageSubscriber stage_b_subscriber;
+    stage_b_dispatcher.subscribe(&stage_b_subscriber);
+
+    std::jthread stage_b_thread([&] {
+        while (stage_b_subscriber.handled_count < event_count) {
+            if (channel.dispatch_available(stage_b_dispatcher) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    EventDispatcher stage_a_dispatcher;
+    SpscChannelForwarder<StageEvent> forwarder { channel, 64 };
+    stage_a_dispatcher.subscribe(&forwarder);
+
+    for (std::uint64_t sequence = 0; sequence < event_count; ++sequence) {
+        stage_a_dispatcher.dispatch(StageEvent { sequence });
+    }
+
+    forwarder.flush();
+    stage_b_thread.join();
+
+    REQUIRE(stage_b_subscriber.handled_count == event_count);
+    REQUIRE(stage_b_subscriber.out_of_order == false);
+}
@@ -0,0 +1,343 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "async/strand.h"
+#include "async/thread_pool.h"
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+/// Test events
+
+struct CountedEvent {
+    int index;
+};
+
+struct OtherCountedEvent {
+    int index;
+};
+
+
+/// Test subscribers
+
+class SerialSubscriber : public dispatch::EventSubscriber<CountedEvent>
+{
+public:
+
+    void handle_event(const CountedEvent& event) override
+    {
+        // Detects any two handler calls overlapping, without locking
+        if (concurrent_handler_count.fetch_add(1) != 0) {
+            overlap_detected = true;
+        }
+
+        handled_index_list.push_back(event.index);
+        handler_thread_id = std::this_thread::get_id();
+
+        concurrent_handler_count.fetch_sub(1);
+    }
+
+    std::vector<int> handled_index_list {};
+    std::thread::id handler_thread_id {};
+    std::atomic<int> concurrent_handler_count = 0;
+    std::atomic<bool> overlap_detected = false;
+};
+
+class TwoTypeSubscriber : public dispatch::EventSubscriber<CountedEvent, OtherCountedEvent>
+{
+public:
+
+    void handle_event(const CountedEvent& event) override
+    {
+        handled_index_list.push_back(event.index);
+    }
+
+    void handle_event(const OtherCountedEvent& event) override
+    {
+        other_handled_index_list.push_back(event.index);
+    }
+
+    std::vector<int> handled_index_list {};
+    std::vector<int> other_handled_index_list {};
+};
+
+// Blocks in its handler until released, so a test can unsubscribe it while it is running
+class BlockingSubscriber : public dispatch::EventSubscriber<CountedEvent>
+{
+public:
+
+    void handle_event(const CountedEvent& event) override
+    {
+        started = true;
+
+        while (!released) {
+            std::this_thread::yield();
+        }
+
+        finished = true;
+    }
+
+    std::atomic<bool> started = false;
+    std::atomic<bool> released = false;
+    std::atomic<bool> finished = false;
+};
+
+// Unsubscribes itself from inside its handler
+class SelfUnsubscribingSubscriber : public dispatch::EventSubscriber<CountedEvent>
+{
+public:
+
+    explicit SelfUnsubscribingSubscriber(dispatch::EventDispatcher& dispatcher)
+        : event_dispatcher(dispatcher)
+    {}
+
+    void handle_event(const CountedEvent& event) override
+    {
+        event_dispatcher.unsubscribe(this);
+        handled = true;
+    }
+
+    dispatch::EventDispatcher& event_dispatcher;
+    std::atomic<bool> handled = false;
+};
+
+
+/// ThreadPool and Strand tests
+
+TEST_CASE("Test ThreadPool runs every posted job before it is destroyed")
+{
+    using namespace dispatch;
+
+    std::atomic<int> job_count = 0;
+
+    {
+        ThreadPool thread_pool { 4 };
+
+        for (int job_index = 0; job_index < 1000; ++job_index) {
+            thread_pool.post([&job_count] { ++job_count; });
+        }
+    }
+
+    REQUIRE(job_count == 1000);
+}
+
+TEST_CASE("Test Strand runs posted tasks one at a time in the order they were posted")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 4 };
+    Strand strand { thread_pool };
+
+    std::vector<int> task_index_list;
+    std::atomic<int> concurrent_task_count = 0;
+    bool overlap_detected = false;
+
+    for (int task_index = 0; task_index < 1000; ++task_index) {
+        strand.post([&, task_index] {
+            overlap_detected |= concurrent_task_count.fetch_add(1) != 0;
+            task_index_list.push_back(task_index);
+            concurrent_task_count.fetch_sub(1);
+        });
+    }
+
+    strand.wait_idle();
+
+    REQUIRE(overlap_detected == false);
+    REQUIRE(task_index_list.size() == 1000);
+    REQUIRE(std::is_sorted(task_index_list.begin(), task_index_list.end()));
+    REQUIRE(strand.get_backlog() == 0);
+}
+
+
+/// EventDispatcher strand tests
+
+TEST_CASE("Test set_strand fails for subscriber that is not subscribed")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    SerialSubscriber subscriber;
+
+    REQUIRE(event_dispatcher.set_strand(&subscriber, &strand) == false);
+}
+
+TEST_CASE("Test events for subscriber bound to a strand are handled on a pool thread")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 2 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    SerialSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    REQUIRE(event_dispatcher.set_strand(&subscriber, &strand) == true);
+
+    event_dispatcher.dispatch(CountedEvent { 12345 });
+    strand.wait_idle();
+
+    REQUIRE(subscriber.handled_index_list == std::vector<int> { 12345 });
+    REQUIRE(subscriber.handler_thread_id != std::this_thread::get_id());
+}
+
+TEST_CASE("Test subscriber bound to a strand never handles two events at once when dispatching from several threads")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 4 };
+    Strand strand_0 { thread_pool };
+    Strand strand_1 { thread_pool };
+    BasicEventDispatcher<MultiThreaded, HashStorage, TracingInstrumentation> event_dispatcher;
+    SerialSubscriber subscriber_0;
+    SerialSubscriber subscriber_1;
+
+    event_dispatcher.subscribe(&subscriber_0);
+    event_dispatcher.subscribe(&subscriber_1);
+    event_dispatcher.set_strand(&subscriber_0, &strand_0);
+    event_dispatcher.set_strand(&subscriber_1, &strand_1);
+
+    {
+        std::vector<std::jthread> dispatcher_thread_list;
+
+        for (int thread_index = 0; thread_index < 4; ++thread_index) {
+            dispatcher_thread_list.emplace_back([&event_dispatcher, thread_index] {
+                for (int event_index = 0; event_index < 500; ++event_index) {
+                    event_dispatcher.dispatch(CountedEvent { thread_index * 500 + event_index });
+                }
+            });
+        }
+    }
+
+    strand_0.wait_idle();
+    strand_1.wait_idle();
+
+    REQUIRE(subscriber_0.overlap_detected == false);
+    REQUIRE(subscriber_1.overlap_detected == false);
+    REQUIRE(subscriber_0.handled_index_list.size() == 2000);
+    REQUIRE(subscriber_1.handled_index_list.size() == 2000);
+}
+
+TEST_CASE("Test events handled inside dispatch after subscriber is unbound from its strand")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    SerialSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_strand(&subscriber, &strand);
+    event_dispatcher.set_strand(&subscriber, nullptr);
+
+    event_dispatcher.dispatch(CountedEvent { 12345 });
+
+    REQUIRE(subscriber.handled_index_list == std::vector<int> { 12345 });
+    REQUIRE(subscriber.handler_thread_id == std::this_thread::get_id());
+}
+
+TEST_CASE("Test events of other types kept on strand when subscriber unsubscribes from one event type")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    TwoTypeSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_strand(&subscriber, &strand);
+
+    // Occupies the pool's only thread, so the subscriber's events stay queued on the strand
+    std::atomic<bool> released = false;
+    thread_pool.post([&released] {
+        while (!released) {
+            std::this_thread::yield();
+        }
+    });
+
+    event_dispatcher.dispatch(CountedEvent { 1 });
+    event_dispatcher.dispatch(OtherCountedEvent { 2 });
+    event_dispatcher.unsubscribe<CountedEvent>(&subscriber);
+
+    released = true;
+    strand.wait_idle();
+
+    REQUIRE(subscriber.handled_index_list.empty());
+    REQUIRE(subscriber.other_handled_index_list == std::vector<int> { 2 });
+}
+
+TEST_CASE("Test unsubscribe waits for the subscriber's handler call already running on its strand")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    BlockingSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_strand(&subscriber, &strand);
+    event_dispatcher.dispatch(CountedEvent { 1 });
+
+    while (!subscriber.started) {
+        std::this_thread::yield();
+    }
+
+    bool finished_when_unsubscribed = false;
+
+    std::thread unsubscribe_thread { [&] {
+        event_dispatcher.unsubscribe(&subscriber);
+        finished_when_unsubscribed = subscriber.finished;
+    } };
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    subscriber.released = true;
+    unsubscribe_thread.join();
+
+    REQUIRE(finished_when_unsubscribed == true);
+}
+
+TEST_CASE("Test subscriber bound to a strand can unsubscribe itself from its handler")
+{
+    using namespace dispatch;
+
+    ThreadPool thread_pool { 1 };
+    Strand strand { thread_pool };
+    EventDispatcher event_dispatcher;
+    SelfUnsubscribingSubscriber subscriber { event_dispatcher };
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.set_strand(&subscriber, &strand);
+    event_dispatcher.dispatch(CountedEvent { 1 });
+    strand.wait_idle();
+
+    REQUIRE(subscriber.handled == true);
+}
@@ -0,0 +1,216 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "event/event_timer_wheel.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+using namespace std::chrono_literals;
+
+
+/// Test events
+
+struct TimeoutEvent {
+    int id;
+};
+
+struct DueEvent {
+    std::uint64_t due_tick;
+};
+
+
+/// Test subscribers
+
+class TimeoutSubscriber : public dispatch::EventSubscriber<TimeoutEvent>
+{
+public:
+
+    void handle_event(const TimeoutEvent& event) override
+    {
+        id_list.push_back(event.id);
+    }
+
+    std::vector<int> id_list {};
+};
+
+class DueSubscriber : public dispatch::EventSubscriber<DueEvent>
+{
+public:
+
+    void handle_event(const DueEvent& event) override
+    {
+        late_or_early_count += event.due_tick != current_tick;
+        ++handled_count;
+    }
+
+    std::uint64_t current_tick = 0;
+    std::size_t late_or_early_count = 0;
+    std::size_t handled_count = 0;
+};
+
+
+/// EventTimerWheel tests
+
+TEST_CASE("Test dispatch_after dispatches event once its delay has elapsed")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    timer_wheel.dispatch_after(10ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.advance(9ms) == 0);
+    REQUIRE(subscriber.id_list.empty());
+    REQUIRE(timer_wheel.advance(1ms) == 1);
+    REQUIRE(subscriber.id_list == std::vector<int> { 1 });
+    REQUIRE(timer_wheel.get_pending_count() == 0);
+}
+
+TEST_CASE("Test dispatch_after dispatches with a multi threaded dispatcher")
+{
+    using namespace dispatch;
+
+    BasicEventDispatcher<MultiThreaded, OrderedStorage, NoInstrumentation> event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    timer_wheel.dispatch_after(2ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.advance(2ms) == 1);
+    REQUIRE(subscriber.id_list == std::vector<int> { 1 });
+}
+
+TEST_CASE("Test timers fire in the order they fall due within one advance")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    timer_wheel.dispatch_after(70000ms, TimeoutEvent { 3 });
+    timer_wheel.dispatch_after(300ms, TimeoutEvent { 2 });
+    timer_wheel.dispatch_after(5ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.advance(100s) == 3);
+    REQUIRE(subscriber.id_list == std::vector<int> { 1, 2, 3 });
+}
+
+TEST_CASE("Test cancelled timer does not fire and cannot be cancelled twice")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    const auto timer_handle = timer_wheel.dispatch_after(1000ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.cancel(timer_handle) == true);
+    REQUIRE(timer_wheel.cancel(timer_handle) == false);
+
+    // The cancelled timer's slot is reused, which must not make the old handle valid again
+    timer_wheel.dispatch_after(1000ms, TimeoutEvent { 2 });
+
+    REQUIRE(timer_wheel.cancel(timer_handle) == false);
+    REQUIRE(timer_wheel.advance(2s) == 1);
+    REQUIRE(subscriber.id_list == std::vector<int> { 2 });
+}
+
+TEST_CASE("Test dispatch_every dispatches event every period until cancelled")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    const auto timer_handle = timer_wheel.dispatch_every(250ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.advance(1s) == 4);
+    REQUIRE(timer_wheel.cancel(timer_handle) == true);
+    REQUIRE(timer_wheel.advance(1s) == 0);
+    REQUIRE(subscriber.id_list.size() == 4);
+}
+
+TEST_CASE("Test advance carries partial ticks into the next call")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    TimeoutSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    timer_wheel.dispatch_after(2ms, TimeoutEvent { 1 });
+
+    REQUIRE(timer_wheel.advance(600us) == 0);
+    REQUIRE(timer_wheel.advance(600us) == 0);
+    REQUIRE(timer_wheel.advance(600us) == 0);
+    REQUIRE(timer_wheel.advance(600us) == 1);
+}
+
+TEST_CASE("Test hundreds of thousands of timers each fire on the tick they fall due")
+{
+    using namespace dispatch;
+
+    EventDispatcher event_dispatcher;
+    EventTimerWheel timer_wheel { event_dispatcher, 1ms };
+    DueSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    std::mt19937_64 random_engine { 12345 };
+    std::uniform_int_distribution<std::uint64_t> delay_distribution { 1, 1 << 20 };
+    std::vector<TimerHandle> timer_handle_list;
+
+    for (int timer_index = 0; timer_index < 200000; ++timer_index) {
+        const auto delay_tick_count = delay_distribution(random_engine);
+        timer_handle_list.push_back(timer_wheel.dispatch_after(std::chrono::milliseconds(delay_tick_count), DueEvent { delay_tick_count }));
+    }
+
+    for (std::size_t timer_index = 0; timer_index < timer_handle_list.size(); timer_index += 2) {
+        timer_wheel.cancel(timer_handle_list[timer_index]);
+    }
+
+    while (timer_wheel.get_pending_count() != 0) {
+        ++subscriber.current_tick;
+        timer_wheel.advance(1ms);
+    }
+
+    REQUIRE(subscriber.handled_count == 100000);
+    REQUIRE(subscriber.late_or_early_count == 0);
+}
@@ -0,0 +1,189 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "event/event_dispatcher.h"
+#include "event/event_subscriber.h"
+#include "request/request.h"
+#include "request/request_dispatcher.h"
+#include "request/request_subscriber.h"
+#include "shared/dispatch_tracer.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+struct TracedEvent {};
+struct TracedRequest : public dispatch::Request<int> {};
+
+
+class TracedEventSubscriber : public dispatch::EventSubscriber<TracedEvent>
+{
+
+public:
+
+    void handle_event(const TracedEvent& event) override {}
+};
+
+class TracedRequestSubscriber : public dispatch::RequestSubscriber<TracedRequest>
+{
+
+public:
+
+    std::optional<int> handle_request(const TracedRequest& request) override
+    {
+        return 12345;
+    }
+};
+
+
+TEST_CASE("Test no spans recorded while tracer is disabled")
+{
+    using namespace dispatch;
+
+    DispatchTracer::disable();
+    DispatchTracer::clear();
+
+    EventDispatcher event_dispatcher;
+    TracedEventSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.dispatch(TracedEvent {});
+
+    REQUIRE(DispatchTracer::collect().empty());
+}
+
+TEST_CASE("Test dispatch and handle_event spans recorded while tracer is enabled")
+{
+    using namespace dispatch;
+
+    DispatchTracer::clear();
+    DispatchTracer::enable();
+
+    EventDispatcher event_dispatcher;
+    TracedEventSubscriber subscriber_0;
+    TracedEventSubscriber subscriber_1;
+
+    event_dispatcher.subscribe(&subscriber_0);
+    event_dispatcher.subscribe(&subscriber_1);
+    event_dispatcher.dispatch(TracedEvent {});
+
+    DispatchTracer::disable();
+
+    const auto span_list = DispatchTracer::collect();
+
+    REQUIRE(span_list.size() == 3);
+
+    REQUIRE(span_list[0].name == "dispatch");
+    REQUIRE(span_list[0].type_name == "TracedEvent");
+    REQUIRE(span_list[0].subscriber == nullptr);
+
+    REQUIRE(span_list[1].name == "handle_event");
+    REQUIRE(span_list[1].type_name == "TracedEvent");
+    REQUIRE(span_list[1].subscriber != nullptr);
+    REQUIRE(span_list[2].subscriber != span_list[1].subscriber);
+
+    for (const auto& handler_span : { span_list[1], span_list[2] }) {
+        REQUIRE(handler_span.begin_ns >= span_list[0].begin_ns);
+        REQUIRE(handler_span.end_ns <= span_list[0].end_ns);
+    }
+}
+
+TEST_CASE("Test spans of exited threads collected once, then their buffers dropped")
+{
+    using namespace dispatch;
+
+    DispatchTracer::clear();
+    DispatchTracer::enable();
+
+    EventDispatcher event_dispatcher;
+    TracedEventSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+
+    std::thread dispatching_thread { [&event_dispatcher] {
+        event_dispatcher.dispatch(TracedEvent {});
+    } };
+
+    dispatching_thread.join();
+
+    DispatchTracer::disable();
+
+    REQUIRE(DispatchTracer::collect().size() == 2);
+    REQUIRE(DispatchTracer::collect().empty());
+}
+
+TEST_CASE("Test dispatch and handle_request spans recorded while tracer is enabled")
+{
+    using namespace dispatch;
+
+    DispatchTracer::clear();
+    DispatchTracer::enable();
+
+    RequestDispatcher request_dispatcher;
+    TracedRequestSubscriber subscriber;
+
+    request_dispatcher.subscribe(&subscriber);
+    auto result = request_dispatcher.dispatch(TracedRequest {});
+
+    DispatchTracer::disable();
+
+    const auto span_list = DispatchTracer::collect();
+
+    REQUIRE(result == 12345);
+    REQUIRE(span_list.size() == 2);
+    REQUIRE(span_list[0].name == "dispatch");
+    REQUIRE(span_list[1].name == "handle_request");
+    REQUIRE(span_list[1].type_name == "TracedRequest");
+}
+
+TEST_CASE("Test chrome trace written to file")
+{
+    using namespace dispatch;
+
+    DispatchTracer::clear();
+    DispatchTracer::enable();
+
+    EventDispatcher event_dispatcher;
+    TracedEventSubscriber subscriber;
+
+    event_dispatcher.subscribe(&subscriber);
+    event_dispatcher.dispatch(TracedEvent {});
+
+    DispatchTracer::disable();
+
+    const auto path = std::filesystem::temp_directory_path() / "dispatchula_trace_test.json";
+    REQUIRE(DispatchTracer::write_chrome_trace(path));
+
+    std::ifstream file { path };
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    REQUIRE(contents.str().starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+    REQUIRE(contents.str().find(R"("name":"dispatch TracedEvent")") != std::string::npos);
+    REQUIRE(contents.str().find(R"("name":"handle_event TracedEvent")") != std::string::npos);
+
+    std::filesystem::remove(path);
+}
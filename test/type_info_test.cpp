@@ -0,0 +1,112 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 PeterBurgess
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE
+ */
+
+
+#include "shared/dispatchula_type_info.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+
+struct SomeType {};
+struct SomeOtherType {};
+struct SomeCollidingType {};
+
+namespace some_namespace {
+    template<class T>
+    struct SomeTemplate {};
+}
+
+namespace {
+    struct LocalType {};
+}
+
+// Defined in type_info_second_unit.cpp, which has its own anonymous namespace `LocalType`
+dispatch::TypeId get_second_unit_local_type_id();
+
+
+TEST_CASE("Test type names are available at compile time")
+{
+    using namespace dispatch;
+
+    STATIC_REQUIRE(type_name_v<SomeType> == "SomeType");
+    STATIC_REQUIRE(type_name_v<some_namespace::SomeTemplate<SomeType>> == "some_namespace::SomeTemplate<SomeType>");
+}
+
+TEST_CASE("Test type ids are available at compile time and differ between types")
+{
+    using namespace dispatch;
+
+    STATIC_REQUIRE(type_id_v<SomeType> == type_id_v<SomeType>);
+    STATIC_REQUIRE(type_id_v<SomeType> != type_id_v<SomeOtherType>);
+    STATIC_REQUIRE(type_id_v<SomeType>.hash != type_id_v<SomeOtherType>.hash);
+    STATIC_REQUIRE(type_id_v<SomeType>.hash == _fnv1a_hash_("SomeType"));
+}
+
+TEST_CASE("Test type ids with colliding hashes do not compare equal")
+{
+    using namespace dispatch;
+
+    const TypeId colliding_type_id { type_id_v<SomeType>.hash, type_name_v<SomeCollidingType>, &_type_id_tag_v<SomeCollidingType> };
+
+    REQUIRE(colliding_type_id != type_id_v<SomeType>);
+    REQUIRE((colliding_type_id < type_id_v<SomeType> || type_id_v<SomeType> < colliding_type_id));
+}
+
+TEST_CASE("Test type id collision detected in map keyed by type id")
+{
+    using namespace dispatch;
+
+    std::map<TypeId, int> type_id_map { { type_id_v<SomeType>, 0 } };
+
+    const TypeId colliding_type_id { type_id_v<SomeType>.hash, type_name_v<SomeCollidingType>, &_type_id_tag_v<SomeCollidingType> };
+
+    REQUIRE(_has_type_id_collision_(type_id_map, type_id_v<SomeType>) == false);
+    REQUIRE(_has_type_id_collision_(type_id_map, type_id_v<SomeOtherType>) == false);
+    REQUIRE(_has_type_id_collision_(type_id_map, colliding_type_id) == true);
+}
+
+TEST_CASE("Test type id collision detected in unordered map keyed by type id")
+{
+    using namespace dispatch;
+
+    std::unordered_map<TypeId, int> type_id_map { { type_id_v<SomeType>, 0 } };
+
+    const TypeId colliding_type_id { type_id_v<SomeType>.hash, type_name_v<SomeCollidingType>, &_type_id_tag_v<SomeCollidingType> };
+
+    REQUIRE(_has_type_id_collision_(type_id_map, type_id_v<SomeType>) == false);
+    REQUIRE(_has_type_id_collision_(type_id_map, type_id_v<SomeOtherType>) == false);
+    REQUIRE(_has_type_id_collision_(type_id_map, colliding_type_id) == true);
+}
+
+TEST_CASE("Test type ids of same named types in anonymous namespaces of different translation units do not compare equal")
+{
+    using namespace dispatch;
+
+    const auto second_unit_type_id = get_second_unit_local_type_id();
+
+    REQUIRE(second_unit_type_id.name == type_id_v<LocalType>.name);
+    REQUIRE(second_unit_type_id.hash == type_id_v<LocalType>.hash);
+    REQUIRE(second_unit_type_id != type_id_v<LocalType>);
+    REQUIRE(get_second_unit_local_type_id() == second_unit_type_id);
+}